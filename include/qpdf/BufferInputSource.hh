@@ -54,6 +54,11 @@ class QPDF_DLL_CLASS BufferInputSource: public InputSource
     void unreadCh(char ch) override;
 
   private:
+    friend class InputSource;
+
+    QPDF_DLL_PRIVATE
+    size_t read_at(qpdf_offset_t offset, char* buffer, size_t length);
+
 #ifndef QPDF_FUTURE
     bool own_memory;
     std::string description;
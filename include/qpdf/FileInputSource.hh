@@ -56,6 +56,11 @@ class QPDF_DLL_CLASS FileInputSource: public InputSource
     void unreadCh(char ch) override;
 
   private:
+    friend class InputSource;
+
+    QPDF_DLL_PRIVATE
+    size_t read_at(qpdf_offset_t offset, char* buffer, size_t length);
+
     bool close_file{false};
     std::string filename;
     FILE* file{nullptr};
@@ -75,6 +75,17 @@ class QPDF_DLL_CLASS InputSource
     // semantically equivalent to seek(-1, SEEK_CUR) but is much more efficient.
     virtual void unreadCh(char ch) = 0;
 
+    // From 12.5: read up to length bytes starting at offset into buffer, and return the number of
+    // bytes read, which is less than length only at the end of the input. For FileInputSource (on
+    // systems that have pread), BufferInputSource, and ReadAheadInputSource over one of those, this
+    // is a single positional read that neither uses nor changes the current position or the last
+    // offset, and any number of threads may call it at the same time. For other input sources, it
+    // is a seek followed by a read, done while holding a lock so that it is also safe to call from
+    // several threads, but it changes the current position. In either case, no other method may be
+    // called while another thread is in readAt.
+    QPDF_DLL
+    size_t readAt(qpdf_offset_t offset, char* buffer, size_t length);
+
     // The following methods are for internal use by qpdf only.
     inline size_t read(std::string& str, size_t count, qpdf_offset_t at = -1);
     inline std::string read(size_t count, qpdf_offset_t at = -1);
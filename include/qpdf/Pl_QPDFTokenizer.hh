@@ -32,6 +32,11 @@
 // QPDFObjectHandle::TokenFilter object. All bytes of incoming content will be included in exactly
 // one token and passed downstream.
 //
+// Since qpdf 12.5, tokens are passed to the filter as soon as they are known to be complete rather
+// than when finish() is called, so the filter runs while the data is still being written, and only
+// the data after the last complete token is kept in memory. Inline images are passed on once the
+// data following them shows where they end.
+//
 // This is a very low-level interface for working with token filters. Most code will want to use
 // QPDFObjectHandle::filterPageContents or QPDFObjectHandle::addTokenFilter. See QPDFObjectHandle.hh
 // for details.
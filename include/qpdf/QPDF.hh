@@ -126,7 +126,9 @@ class QPDF
     // appending "-nnn" to file_prefix, where "nnn" is the object number (not zero-filled). If
     // wanted_objects is empty, write all objects. Otherwise, write only objects whose keys are in
     // wanted_objects. Keys may be either "trailer" or of the form "obj:n n R". Invalid keys are
-    // ignored. This corresponds to the --json-object command-line argument.
+    // ignored. This corresponds to the --json-object command-line argument. From 12.5, when
+    // wanted_objects is not empty, only the wanted objects are read from the input, and
+    // "maxobjectid" is the highest object number known without reading the remaining objects.
     //
     // QPDF is efficient with regard to memory when writing, allowing you to write arbitrarily large
     // PDF files to a pipeline. You can use a pipeline like Pl_Buffer or Pl_String to capture the
@@ -267,6 +269,50 @@ class QPDF
     QPDF_DLL
     void setImmediateCopyFrom(bool);
 
+    // From 12.5: by default, the first time the page manipulation APIs (addPage, addPageAt,
+    // removePage, and the equivalent QPDFPageDocumentHelper methods) or findPage are used, qpdf
+    // pushes inherited attributes down to the pages and flattens the /Pages tree so that every page
+    // is a direct kid of the root /Pages object. Inserting or removing a page then updates the
+    // single /Kids array and the position of every subsequent page, which makes long sequences of
+    // insertions and removals quadratic in the number of pages. If this method is called with a
+    // fanout of 3 or more before pages are manipulated, qpdf instead rebuilds the /Pages tree as a
+    // balanced tree in which no /Pages node has more than `fanout` kids. The tree, including /Count
+    // and /Parent entries, is maintained as pages are added and removed, so insertion, removal, and
+    // findPage take time proportional to the fanout times the depth of the tree, and files written
+    // afterwards contain the balanced tree. A fanout of 0, the default, selects flattening. If the
+    // /Pages tree has already been prepared for manipulation, the new setting takes effect after
+    // the next call to updateAllPagesCache(). An std::invalid_argument is thrown for a fanout of 1
+    // or 2, since a tree whose nodes may have a single kid doesn't stay balanced.
+    QPDF_DLL
+    void setPagesTreeFanout(size_t fanout);
+
+    // From 12.5: use a cross-reference index file to avoid reading the cross-reference tables or
+    // streams of the input. This must be called before processFile or any of the other process
+    // methods. If the index file exists and was written by writeXRefIndexFile for an input with the
+    // same size and the same final 1054 bytes, which is the region that contains the trailer and
+    // startxref, the cross-reference table and trailer are loaded from it, skipping xref parsing
+    // and, for damaged files, xref reconstruction. Loading an index for a damaged file issues a
+    // warning, and such an index is not used if recovery has been disabled with
+    // setAttemptRecovery(false). Otherwise, including if the index file can't be read or is
+    // truncated, the input is processed normally. Use usedXRefIndexFile to find out which happened.
+    // This is intended for inputs that are opened repeatedly and never modified in place.
+    QPDF_DLL
+    void setXRefIndexFile(std::string const& filename);
+
+    // From 12.5: return true if the cross-reference table was loaded from the index file given to
+    // setXRefIndexFile.
+    QPDF_DLL
+    bool usedXRefIndexFile() const;
+
+    // From 12.5: set the number of threads used to scan the file when the cross-reference table of
+    // a damaged file has to be reconstructed. The file is split into chunks that are scanned
+    // concurrently, and the results are merged so that the reconstructed table and any warnings are
+    // exactly the same as with a single thread. A value of 1 always scans the file with a single
+    // thread. The default value of 0 uses one thread per available processor for files that are
+    // large enough to benefit and a single thread otherwise.
+    QPDF_DLL
+    void setXRefReconstructionThreads(size_t threads);
+
     // Other public methods
 
     // Return the list of warnings that have been issued so far and clear the list.  This method may
@@ -645,6 +691,14 @@ class QPDF
     QPDF_DLL
     void showXRefTable();
 
+    // From 12.5: write the cross-reference table and trailer of the input file to an index file
+    // that can be used with setXRefIndexFile to open the same file more quickly later. This should
+    // be called right after processing the file since the index contains the trailer dictionary in
+    // its current state. The index is written to a temporary file that is then renamed, so readers
+    // never see a partially written index. An exception is thrown if the file can't be written.
+    QPDF_DLL
+    void writeXRefIndexFile(std::string const& filename);
+
     // Starting from qpdf 11.0 user code should not need to call this method. Before 11.0 this
     // method was used to detect all indirect references to objects that don't exist and resolve
     // them by replacing them with null, which is how the PDF spec says to interpret such dangling
@@ -660,11 +714,54 @@ class QPDF
     QPDF_DLL
     size_t getObjectCount();
 
+    // From 12.5: return the number of objects that have been read from the input so far. Objects
+    // are read lazily as they are accessed, so this can be used to see how much of a file an
+    // operation actually touched. When an object from an object stream is resolved, all objects in
+    // that object stream are read and counted.
+    QPDF_DLL
+    size_t getResolvedObjectCount() const;
+
     // Returns a list of indirect objects for every object in the xref table. Useful for discovering
     // objects that are not otherwise referenced.
     QPDF_DLL
     std::vector<QPDFObjectHandle> getAllObjects();
 
+    // From 12.5: read every object in the file so that the QPDF object can afterwards be read by
+    // several threads at once without external locking. Once this method returns, any number of
+    // threads may simultaneously call getRoot, getTrailer, getObject, and getAllPages, read objects with the const methods of QPDFObjectHandle (getKey, getArrayItem,
+    // unparse, and so on), and retrieve stream data with getStreamData, getRawStreamData, or
+    // pipeStreamData. Raw stream data is read with InputSource::readAt, so reads from files and
+    // memory buffers happen in parallel, as do decryption and decoding. The QPDF object and its objects must not be modified while
+    // other threads are reading them. Calling this method more than once has no further effect.
+    QPDF_DLL
+    void makeReadOnlySnapshot();
+
+    // From 12.5: digests of a stream's data as computed by getStreamDigests. Digests are lower-case
+    // hexadecimal strings.
+    struct StreamDigests
+    {
+        std::string raw_md5;
+        std::string raw_sha256;
+        // Whether the stream data could be decoded at the requested decode level. If so, the
+        // following are the digests of the decoded data; otherwise they are empty.
+        bool decoded{false};
+        std::string decoded_md5;
+        std::string decoded_sha256;
+    };
+
+    // From 12.5: compute the MD5 and SHA-256 digests of the raw and decoded data of each stream in
+    // objects, using the configured crypto provider. Objects that are not streams are ignored, as
+    // are streams whose data can't be read. Data is decoded as by getStreamData at decode_level;
+    // with qpdf_dl_none, only the raw digests are computed. Stream data is read on the calling
+    // thread, and decoding and hashing are done on up to `threads` threads, or the number of
+    // hardware threads if `threads` is 0. Only the data of one stream per thread is held in memory
+    // at a time. Warnings are issued for streams whose data can't be read or decoded.
+    QPDF_DLL
+    std::map<QPDFObjGen, StreamDigests> getStreamDigests(
+        std::vector<QPDFObjectHandle> const& objects,
+        qpdf_stream_decode_level_e decode_level,
+        size_t threads = 0);
+
     // Optimization support -- see doc/optimization.  Implemented in QPDF_optimization.cc
 
     // The object_stream_data map maps from a "compressed" object to the object stream that contains
@@ -479,6 +479,8 @@ class QPDFJob
     // Transformations
     void handlePageSpecs(QPDF& pdf);
     bool shouldRemoveUnreferencedResources(QPDF& pdf);
+    bool
+    shouldRemoveUnreferencedResources(QPDF& pdf, std::vector<QPDFObjectHandle> const& nodes);
     void handleRotations(QPDF& pdf);
     void getUOPagenos(
         std::vector<UnderOverlay>& uo, std::vector<std::map<size_t, std::vector<int>>>& pagenos);
@@ -524,6 +526,7 @@ class QPDFJob
     void doJSONAcroform(Pipeline* p, bool& first, QPDF& pdf);
     void doJSONEncrypt(Pipeline* p, bool& first, QPDF& pdf);
     void doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf);
+    void doJSONStreamDigests(Pipeline* p, bool& first, QPDF& pdf);
     void addOutlinesToJson(
         std::vector<QPDFOutlineObjectHelper> outlines,
         JSON& j,
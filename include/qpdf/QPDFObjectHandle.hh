@@ -139,6 +139,8 @@ class QPDFObjectHandle: public qpdf::BaseHandle
     //
     // The handleToken method is called for each token, including the eof token, and then handleEOF
     // is called at the very end. Handlers may call write (or writeToken) to pass data downstream.
+    // Tokens are passed to handleToken while the stream data is being read, so the whole content
+    // stream is never held in memory at once.
     // Please see examples/pdf-filter-tokens.cc and examples/pdf-count-strings.cc for examples of
     // using TokenFilters.
     //
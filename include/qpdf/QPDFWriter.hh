@@ -234,6 +234,51 @@ class QPDFWriter
     QPDF_DLL
     void setNewlineBeforeEndstream(bool);
 
+    // From 12.5: rebuild the pages tree as a balanced tree in which no /Pages node has more than
+    // `fanout` kids before writing. Inherited attributes are pushed down to the pages. This
+    // modifies the QPDF object being written, and the page manipulation APIs maintain the balanced
+    // tree from then on as described for QPDF::setPagesTreeFanout. A value of 0, the default,
+    // leaves the pages tree alone. As with QPDF::setPagesTreeFanout, std::invalid_argument is
+    // thrown for a fanout of 1 or 2.
+    QPDF_DLL
+    void setPagesTreeFanout(size_t fanout);
+
+    // From 12.5: write identical streams only once. Before writing, streams that are reachable from
+    // the trailer and that have the same dictionary, apart from /Length, and the same raw data are
+    // detected, and references to all but the one with the lowest object number are replaced with
+    // references to that one. This is useful when pages from many files that share fonts, color
+    // profiles, or images have been combined. Stream data is only read and hashed for streams whose
+    // dictionaries match another stream's, and each stream is hashed at most once. Since replacing
+    // references can make more stream dictionaries identical, this is repeated until no more
+    // duplicates are found. This modifies the QPDF object being written.
+    QPDF_DLL
+    void setDeduplicateStreams(bool);
+
+    // From 12.5: return the number of streams that were found to be duplicates and the number of
+    // bytes of raw stream data that were not written as a result while writing with
+    // setDeduplicateStreams(true).
+    QPDF_DLL
+    size_t getDeduplicatedStreamCount() const;
+    QPDF_DLL
+    size_t getDeduplicatedStreamBytes() const;
+
+    // From 12.5: write structurally identical indirect objects other than streams only once. This
+    // works like setDeduplicateStreams: objects that are reachable from the trailer and have the
+    // same value are detected, and references to all but the one with the lowest object number are
+    // replaced with references to that one, repeating until no more duplicates are found. Objects
+    // referenced from the trailer and objects whose identity matters are never merged. These are
+    // pages, pages tree nodes, annotations (dictionaries with /Rect), form fields (dictionaries with
+    // /FT or /T), dictionaries with /Parent, outlines, and structure tree nodes. This reduces the
+    // number of objects, for example, when a producer creates an identical resource or border
+    // dictionary for every page. This modifies the QPDF object being written.
+    QPDF_DLL
+    void setDeduplicateObjects(bool);
+
+    // From 12.5: return the number of objects other than streams that were found to be duplicates
+    // while writing with setDeduplicateObjects(true).
+    QPDF_DLL
+    size_t getDeduplicatedObjectCount() const;
+
     // Set the minimum PDF version.  If the PDF version of the input file (or previously set minimum
     // version) is less than the version passed to this method, the PDF version of the output file
     // will be set to this value.  If the original PDF file's version or previously set minimum
@@ -0,0 +1,83 @@
+// Copyright (c) 2005-2021 Jay Berkenbilt
+// Copyright (c) 2022-2026 Jay Berkenbilt and Manfred Holger
+//
+// This file is part of qpdf.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under
+// the License.
+//
+// Versions of qpdf prior to version 7 were released under the terms of version 2.0 of the Artistic
+// License. At your option, you may continue to consider qpdf to be licensed under those terms.
+// Please see the manual for additional information.
+
+#ifndef QPDF_READAHEADINPUTSOURCE_HH
+#define QPDF_READAHEADINPUTSOURCE_HH
+
+#include <qpdf/InputSource.hh>
+
+#include <memory>
+
+// From 12.5: an input source that reads another input source in blocks of a fixed size and keeps
+// the most recently used blocks in memory. Small reads, such as those done while tokenizing, are
+// served from the cached blocks, and so are backward scans, such as searching for startxref or
+// reading a damaged file's objects in reverse order. Reads of at least a block are passed straight
+// to the underlying input source. This is most useful over FileInputSource, where it avoids
+// repeatedly refilling the file's buffer after seeking, and over ClosedFileInputSource, where every
+// underlying read opens and closes the file. The underlying input source must not be used directly
+// while it is being read through this one.
+class QPDF_DLL_CLASS ReadAheadInputSource: public InputSource
+{
+  public:
+    // Read the underlying input source in blocks of block_size bytes, keeping at most max_blocks
+    // of them in memory.
+    QPDF_DLL
+    ReadAheadInputSource(
+        std::shared_ptr<InputSource> source, size_t block_size = 65536, size_t max_blocks = 4);
+
+    ReadAheadInputSource(ReadAheadInputSource const&) = delete;
+    ReadAheadInputSource& operator=(ReadAheadInputSource const&) = delete;
+
+    QPDF_DLL
+    ~ReadAheadInputSource() override;
+    QPDF_DLL
+    qpdf_offset_t findAndSkipNextEOL() override;
+    QPDF_DLL
+    std::string const& getName() const override;
+    QPDF_DLL
+    qpdf_offset_t tell() override;
+    QPDF_DLL
+    void seek(qpdf_offset_t offset, int whence) override;
+    QPDF_DLL
+    void rewind() override;
+    QPDF_DLL
+    size_t read(char* buffer, size_t length) override;
+    QPDF_DLL
+    void unreadCh(char ch) override;
+
+    // The number of reads done on the underlying input source and the number of bytes they
+    // returned. Comparing these with the reads done on this input source shows how much the cache
+    // saved.
+    QPDF_DLL
+    size_t getUnderlyingReads() const;
+    QPDF_DLL
+    size_t getUnderlyingBytes() const;
+
+  private:
+    friend class InputSource;
+
+    QPDF_DLL_PRIVATE
+    size_t read_at(qpdf_offset_t offset, char* buffer, size_t length);
+
+    class Members;
+
+    std::unique_ptr<Members> m;
+};
+
+#endif // QPDF_READAHEADINPUTSOURCE_HH
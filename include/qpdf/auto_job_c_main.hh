@@ -10,6 +10,8 @@ QPDF_DLL Config* check();
 QPDF_DLL Config* checkLinearization();
 QPDF_DLL Config* coalesceContents();
 QPDF_DLL Config* decrypt();
+QPDF_DLL Config* deduplicateObjects();
+QPDF_DLL Config* deduplicateStreams();
 QPDF_DLL Config* deterministicId();
 QPDF_DLL Config* externalizeInlineImages();
 QPDF_DLL Config* filteredStreamData();
@@ -19,6 +21,7 @@ QPDF_DLL Config* ignoreXrefStreams();
 QPDF_DLL Config* isEncrypted();
 QPDF_DLL Config* jsonInput();
 QPDF_DLL Config* keepInlineImages();
+QPDF_DLL Config* lazyPageAccess();
 QPDF_DLL Config* linearize();
 QPDF_DLL Config* listAttachments();
 QPDF_DLL Config* newlineBeforeEndstream();
@@ -65,11 +68,13 @@ QPDF_DLL Config* minVersion(std::string const& parameter);
 QPDF_DLL Config* oiMinArea(std::string const& parameter);
 QPDF_DLL Config* oiMinHeight(std::string const& parameter);
 QPDF_DLL Config* oiMinWidth(std::string const& parameter);
+QPDF_DLL Config* pagesTreeFanout(std::string const& parameter);
 QPDF_DLL Config* password(std::string const& parameter);
 QPDF_DLL Config* removeAttachment(std::string const& parameter);
 QPDF_DLL Config* rotate(std::string const& parameter);
 QPDF_DLL Config* showAttachment(std::string const& parameter);
 QPDF_DLL Config* showObject(std::string const& parameter);
+QPDF_DLL Config* threads(std::string const& parameter);
 QPDF_DLL Config* copyEncryption(std::string const& parameter);
 QPDF_DLL Config* jobJsonFile(std::string const& parameter);
 QPDF_DLL Config* linearizePass1(std::string const& parameter);
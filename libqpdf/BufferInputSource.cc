@@ -131,6 +131,20 @@ BufferInputSource::read(char* buffer, size_t length)
     return len;
 }
 
+size_t
+BufferInputSource::read_at(qpdf_offset_t offset, char* buffer, size_t length)
+{
+    if (offset < 0) {
+        throw std::runtime_error(description + ": seek before beginning of buffer");
+    }
+    if (offset >= max_offset) {
+        return 0;
+    }
+    size_t len = std::min(QIntC::to_size(max_offset - offset), length);
+    memcpy(buffer, buf->getBuffer() + offset, len);
+    return len;
+}
+
 void
 BufferInputSource::unreadCh(char ch)
 {
@@ -211,6 +225,11 @@ BufferInputSource::read(char* buffer, size_t length)
     last_offset = m->is.getLastOffset();
     return result;
 }
+size_t
+BufferInputSource::read_at(qpdf_offset_t offset, char* buffer, size_t length)
+{
+    return m->is.read_at(offset, buffer, length);
+}
 void
 BufferInputSource::unreadCh(char ch)
 {
@@ -293,3 +312,19 @@ is::OffsetBuffer::read(char* buffer, size_t length)
     pos += QIntC::to_offset(len);
     return len;
 }
+
+size_t
+is::OffsetBuffer::read_at(qpdf_offset_t offset, char* buffer, size_t length) const
+{
+    auto start = offset - global_offset;
+    if (start < 0) {
+        throw std::runtime_error(description + ": seek before beginning of buffer");
+    }
+    auto end_pos = static_cast<qpdf_offset_t>(view_.size());
+    if (start >= end_pos) {
+        return 0;
+    }
+    size_t len = std::min(QIntC::to_size(end_pos - start), length);
+    memcpy(buffer, view_.data() + start, len);
+    return len;
+}
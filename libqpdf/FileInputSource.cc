@@ -1,9 +1,17 @@
+#include <qpdf/qpdf-config.h> // include first for large file support
 #include <qpdf/FileInputSource.hh>
 
+#include <qpdf/QIntC.hh>
 #include <qpdf/QPDFExc.hh>
 #include <qpdf/QUtil.hh>
 #include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
+#ifdef HAVE_PREAD
+# include <unistd.h>
+#endif
 
 FileInputSource::FileInputSource(char const* filename) :
     close_file(true),
@@ -127,6 +135,37 @@ FileInputSource::read(char* buffer, size_t length)
     return len;
 }
 
+#ifdef HAVE_PREAD
+size_t
+FileInputSource::read_at(qpdf_offset_t offset, char* buffer, size_t length)
+{
+    // pread reads from the file descriptor without moving its position, so it neither disturbs nor
+    // is affected by the FILE's position and buffer, and several threads can use it at once.
+    if (offset < 0 || offset > std::numeric_limits<off_t>::max() - QIntC::to_offset(length)) {
+        throw std::range_error(
+            filename + ": offset " + std::to_string(offset) + " is out of range for reading");
+    }
+    size_t len = 0;
+    while (len < length) {
+        auto count = ::pread(
+            fileno(file), buffer + len, length - len, static_cast<off_t>(offset + QIntC::to_offset(len)));
+        if (count > 0) {
+            len += static_cast<size_t>(count);
+        } else if (count == 0) {
+            break;
+        } else if (errno != EINTR) {
+            throw QPDFExc(
+                qpdf_e_system,
+                filename,
+                "",
+                offset,
+                (std::string("read ") + std::to_string(length) + " bytes"));
+        }
+    }
+    return len;
+}
+#endif
+
 void
 FileInputSource::unreadCh(char ch)
 {
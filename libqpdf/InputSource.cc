@@ -1,10 +1,16 @@
+#include <qpdf/qpdf-config.h> // include first for large file support
 #include <qpdf/InputSource_private.hh>
 
+#include <qpdf/BufferInputSource.hh>
+#include <qpdf/FileInputSource.hh>
+#include <qpdf/OffsetInputSource.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QTC.hh>
+#include <qpdf/ReadAheadInputSource.hh>
 #include <qpdf/Util.hh>
 
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
 
 using namespace std::literals;
@@ -22,6 +28,43 @@ InputSource::getLastOffset() const
     return this->last_offset;
 }
 
+size_t
+InputSource::readAt(qpdf_offset_t offset, char* buffer, size_t length)
+{
+#ifdef HAVE_PREAD
+    if (auto file = dynamic_cast<FileInputSource*>(this)) {
+        return file->read_at(offset, buffer, length);
+    }
+#endif
+    if (auto buf = dynamic_cast<BufferInputSource*>(this)) {
+        return buf->read_at(offset, buffer, length);
+    }
+    if (auto buf = dynamic_cast<is::OffsetBuffer*>(this)) {
+        return buf->read_at(offset, buffer, length);
+    }
+    if (auto offset_source = dynamic_cast<OffsetInputSource*>(this)) {
+        return offset_source->read_at(offset, buffer, length);
+    }
+    if (auto read_ahead = dynamic_cast<ReadAheadInputSource*>(this)) {
+        return read_ahead->read_at(offset, buffer, length);
+    }
+
+    // Any other input source, including those defined outside of qpdf, can only seek and read. The
+    // lock is recursive in case such an input source is implemented in terms of another one.
+    static std::recursive_mutex mutex;
+    std::lock_guard lock(mutex);
+    seek(offset, SEEK_SET);
+    size_t len = 0;
+    while (len < length) {
+        auto count = read(buffer + len, length - len);
+        if (count == 0) {
+            break;
+        }
+        len += count;
+    }
+    return len;
+}
+
 size_t
 InputSource::read_line(std::string& str, size_t count, qpdf_offset_t at)
 {
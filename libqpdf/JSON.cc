@@ -1,5 +1,6 @@
 #include <qpdf/JSON.hh>
 
+#include <qpdf/JSON_private.hh>
 #include <qpdf/JSON_writer.hh>
 
 #include <qpdf/InputSource_private.hh>
@@ -10,6 +11,7 @@
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
 
+#include <charconv>
 #include <cstring>
 #include <stdexcept>
 
@@ -131,7 +133,7 @@ JSON::JSON_string::JSON_string(std::string const& utf8) :
 void
 JSON::JSON_string::write(Pipeline* p, size_t) const
 {
-    *p << std::string("\"") + Writer::encode_string(utf8) + "\"";
+    Writer(p, 0) << "\"" << Writer::encoded(utf8) << "\"";
 }
 
 JSON::JSON_number::JSON_number(long long value) :
@@ -141,9 +143,23 @@ JSON::JSON_number::JSON_number(long long value) :
 }
 
 JSON::JSON_number::JSON_number(double value) :
-    JSON_value(vt_number),
-    encoded(QUtil::double_to_string(value, 6))
+    JSON_value(vt_number)
 {
+    // Same as QUtil::double_to_string(value, 6) without going through a stream.
+    char buf[400];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 6);
+    if (result.ec != std::errc()) {
+        encoded = QUtil::double_to_string(value, 6);
+        return;
+    }
+    std::string_view sv(buf, static_cast<size_t>(result.ptr - buf));
+    while (sv.size() > 1 && sv.back() == '0') {
+        sv.remove_suffix(1);
+    }
+    if (sv.size() > 1 && sv.back() == '.') {
+        sv.remove_suffix(1);
+    }
+    encoded = sv;
 }
 
 JSON::JSON_number::JSON_number(std::string const& value) :
@@ -215,63 +231,109 @@ JSON::unparse() const
     return s;
 }
 
-std::string
-JSON::Writer::encode_string(std::string const& str)
+namespace
 {
-    static auto constexpr hexchars = "0123456789abcdef";
-
-    auto begin = str.cbegin();
-    auto end = str.cend();
-    auto iter = begin;
-    while (iter != end) {
-        auto c = static_cast<unsigned char>(*iter);
-        if ((c > 34 && c != '\\') || c == ' ' || c == 33) {
-            // Optimistically check that no char in str requires escaping. Hopefully we can just
-            // return the input str.
-            ++iter;
-        } else {
-            // We found a char that requires escaping. Initialize result to the chars scanned so
-            // far, append/replace the rest of str one char at a time, and return the result.
-            std::string result{begin, iter};
-
-            for (; iter != end; ++iter) {
-                auto ch = static_cast<unsigned char>(*iter);
-                if ((ch > 34 && ch != '\\') || ch == ' ' || ch == 33) {
-                    // Check for most common case first.
-                    result += *iter;
-                } else {
-                    switch (ch) {
-                    case '\\':
-                        result += "\\\\";
-                        break;
-                    case '\"':
-                        result += "\\\"";
-                        break;
-                    case '\b':
-                        result += "\\b";
-                        break;
-                    case '\f':
-                        result += "\\f";
-                        break;
-                    case '\n':
-                        result += "\\n";
-                        break;
-                    case '\r':
-                        result += "\\r";
-                        break;
-                    case '\t':
-                        result += "\\t";
-                        break;
-                    default:
-                        result += ch < 16 ? "\\u000" : "\\u001";
-                        result += hexchars[ch % 16];
-                    }
+    inline bool
+    needs_escape(unsigned char ch)
+    {
+        return ch < 32 || ch == '"' || ch == '\\';
+    }
+
+    // Return the length of the longest prefix of 'str' that contains no characters that need to be
+    // escaped. The input is checked eight bytes at a time: a byte needs escaping if it is less than
+    // 0x20 or equal to '"' or '\'. The bit tricks below detect whether any byte of a word has
+    // that property without looking at the bytes individually.
+    size_t
+    unescaped_prefix(std::string_view str)
+    {
+        static constexpr uint64_t ones = 0x0101010101010101ULL;
+        static constexpr uint64_t highs = 0x8080808080808080ULL;
+        size_t i = 0;
+        for (; i + 8 <= str.size(); i += 8) {
+            uint64_t w;
+            std::memcpy(&w, str.data() + i, 8);
+            auto quote = w ^ (ones * '"');
+            auto backslash = w ^ (ones * '\\');
+            if ((((w - ones * 0x20) & ~w) | ((quote - ones) & ~quote) |
+                 ((backslash - ones) & ~backslash)) &
+                highs) {
+                break;
+            }
+        }
+        while (i < str.size() && !needs_escape(static_cast<unsigned char>(str[i]))) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Call 'append' with consecutive pieces of the JSON-encoded form of 'str'. Runs of characters
+    // that don't need escaping are passed on in one piece.
+    template <typename F>
+    void
+    encode(std::string_view str, F&& append)
+    {
+        static auto constexpr hexchars = "0123456789abcdef";
+        while (true) {
+            auto n = unescaped_prefix(str);
+            if (n > 0) {
+                append(str.substr(0, n));
+            }
+            if (n == str.size()) {
+                return;
+            }
+            auto ch = static_cast<unsigned char>(str[n]);
+            switch (ch) {
+            case '\\':
+                append("\\\\");
+                break;
+            case '\"':
+                append("\\\"");
+                break;
+            case '\b':
+                append("\\b");
+                break;
+            case '\f':
+                append("\\f");
+                break;
+            case '\n':
+                append("\\n");
+                break;
+            case '\r':
+                append("\\r");
+                break;
+            case '\t':
+                append("\\t");
+                break;
+            default:
+                {
+                    char u[6] = {'\\', 'u', '0', '0', ch < 16 ? '0' : '1', hexchars[ch % 16]};
+                    append(std::string_view(u, 6));
                 }
             }
-            return result;
+            str.remove_prefix(n + 1);
         }
     }
-    return str;
+} // namespace
+
+std::string
+JSON::Writer::encode_string(std::string const& str)
+{
+    if (unescaped_prefix(str) == str.size()) {
+        // Nothing needs escaping, which is by far the most common case.
+        return str;
+    }
+    std::string result;
+    result.reserve(str.size() + str.size() / 8 + 8);
+    encode(str, [&result](std::string_view sv) { result += sv; });
+    return result;
+}
+
+void
+JSON::Writer::write_encoded(Pipeline* p, std::string_view str)
+{
+    encode(str, [p](std::string_view sv) {
+        p->write(reinterpret_cast<unsigned char const*>(sv.data()), sv.size());
+    });
 }
 
 JSON
@@ -576,6 +638,7 @@ namespace
         JSONParser(InputSource& is, JSON::Reactor* reactor) :
             is(is),
             reactor(reactor),
+            streaming_reactor(dynamic_cast<impl::JSONStreamingReactor*>(reactor)),
             p(buf)
         {
         }
@@ -647,6 +710,7 @@ namespace
 
         InputSource& is;
         JSON::Reactor* reactor;
+        impl::JSONStreamingReactor* streaming_reactor;
         lex_state_e lex_state{ls_top};
         char buf[16384];
         size_t bytes{0};
@@ -656,6 +720,9 @@ namespace
         qpdf_offset_t offset{0};
         bool done{false};
         std::string token;
+        // The value of the current string token is not needed and only kept for the current
+        // buffer.
+        bool skip_string{false};
         qpdf_offset_t token_start{0};
         parser_state_e parser_state{ps_top};
         std::vector<StackFrame> stack;
@@ -813,6 +880,9 @@ JSONParser::getToken()
 
     while (true) {
         if (p == (buf + bytes)) {
+            if (skip_string) {
+                token.clear();
+            }
             p = buf;
             bytes = is.read(buf, sizeof(buf));
             if (bytes == 0) {
@@ -905,6 +975,8 @@ JSONParser::getToken()
             case ls_top:
                 token_start = offset;
                 if (*p == '"') {
+                    skip_string = streaming_reactor && parser_state == ps_dict_after_colon &&
+                        streaming_reactor->skipStringValue(dict_key);
                     ignore(ls_string);
                 } else if ((*p >= 'a') && (*p <= 'z')) {
                     append(ls_alpha);
@@ -1222,7 +1294,8 @@ JSONParser::handleToken()
             parser_state = ps_dict_after_key;
             return;
         } else {
-            item = JSON::makeString(token);
+            item = JSON::makeString(skip_string ? std::string() : token);
+            skip_string = false;
         }
         break;
 
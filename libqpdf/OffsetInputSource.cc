@@ -8,6 +8,19 @@
 
 using namespace qpdf;
 
+namespace
+{
+    std::range_error
+    overflow(qpdf_offset_t offset, qpdf_offset_t global_offset)
+    {
+        std::ostringstream msg;
+        msg.imbue(std::locale::classic());
+        msg << "seeking to " << offset << " offset by " << global_offset
+            << " would cause an overflow of the offset type";
+        return std::range_error(msg.str());
+    }
+} // namespace
+
 OffsetInputSource::OffsetInputSource(
     std::shared_ptr<InputSource> proxied, qpdf_offset_t global_offset) :
     proxied(proxied),
@@ -40,11 +53,7 @@ OffsetInputSource::seek(qpdf_offset_t offset, int whence)
 {
     if (whence == SEEK_SET) {
         if (offset > max_safe_offset) {
-            std::ostringstream msg;
-            msg.imbue(std::locale::classic());
-            msg << "seeking to " << offset << " offset by " << global_offset
-                << " would cause an overflow of the offset type";
-            throw std::range_error(msg.str());
+            throw overflow(offset, global_offset);
         }
         proxied->seek(offset + global_offset, whence);
     } else {
@@ -67,6 +76,16 @@ OffsetInputSource::read(char* buffer, size_t length)
     return result;
 }
 
+size_t
+OffsetInputSource::read_at(qpdf_offset_t offset, char* buffer, size_t length)
+{
+    if (offset > max_safe_offset) {
+        throw overflow(offset, global_offset);
+    }
+    util::no_ci_rt_error_if(offset < 0, "offset input source: seek before beginning of file");
+    return proxied->readAt(offset + global_offset, buffer, length);
+}
+
 void
 OffsetInputSource::unreadCh(char ch)
 {
@@ -2,11 +2,25 @@
 
 #include <qpdf/Util.hh>
 
+#include <charconv>
 #include <cstring>
 #include <stdexcept>
 
 using namespace qpdf;
 
+namespace
+{
+    // Write an integer without creating a temporary string.
+    template <typename T>
+    void
+    write_integer(Pipeline& p, T i)
+    {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), i);
+        p.write(buf, static_cast<size_t>(result.ptr - buf));
+    }
+} // namespace
+
 Pipeline::Pipeline(char const* identifier, Pipeline* next) :
     identifier(identifier),
     next_(next)
@@ -56,56 +70,56 @@ Pipeline::operator<<(std::string const& str)
 Pipeline&
 Pipeline::operator<<(short i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(int i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(long i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(long long i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(unsigned short i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(unsigned int i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(unsigned long i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
 Pipeline&
 Pipeline::operator<<(unsigned long long i)
 {
-    writeString(std::to_string(i));
+    write_integer(*this, i);
     return *this;
 }
 
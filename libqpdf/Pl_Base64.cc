@@ -35,7 +35,18 @@ Pl_Base64::Pl_Base64(char const* identifier, Pipeline* next, action_e action) :
 void
 Pl_Base64::write(unsigned char const* data, size_t len)
 {
-    in_buffer.append(reinterpret_cast<const char*>(data), len);
+    // Data is converted as it arrives, so only a partial group of input characters is held back
+    // between writes.
+    std::string_view in(reinterpret_cast<const char*>(data), len);
+    if (action == a_decode) {
+        decode_internal(in);
+    } else {
+        encode_internal(in);
+    }
+    if (next() && !out_buffer.empty()) {
+        next()->write(reinterpret_cast<unsigned char const*>(out_buffer.data()), out_buffer.size());
+        out_buffer.clear();
+    }
 }
 
 std::string
@@ -43,6 +54,7 @@ Pl_Base64::decode(std::string_view data)
 {
     Pl_Base64 p("base64-decode", nullptr, a_decode);
     p.decode_internal(data);
+    p.finish_internal();
     return std::move(p.out_buffer);
 }
 
@@ -51,6 +63,7 @@ Pl_Base64::encode(std::string_view data)
 {
     Pl_Base64 p("base64-encode", nullptr, a_encode);
     p.encode_internal(data);
+    p.finish_internal();
     return std::move(p.out_buffer);
 }
 
@@ -58,7 +71,7 @@ void
 Pl_Base64::decode_internal(std::string_view data)
 {
     auto len = data.size();
-    auto res = (len / 4u + 1u) * 3u;
+    auto res = out_buffer.size() + (len / 4u + 1u) * 3u;
     out_buffer.reserve(res);
     unsigned char const* p = reinterpret_cast<const unsigned char*>(data.data());
     while (len > 0) {
@@ -71,12 +84,6 @@ Pl_Base64::decode_internal(std::string_view data)
         ++p;
         --len;
     }
-    if (pos > 0) {
-        for (size_t i = pos; i < 4; ++i) {
-            buf[i] = '=';
-        }
-        flush_decode();
-    }
     qpdf_assert_debug(out_buffer.size() <= res);
 }
 
@@ -90,7 +97,7 @@ Pl_Base64::encode_internal(std::string_view data)
         throw std::length_error(getIdentifier() + ": base64 decode: data exceeds maximum length");
     }
 
-    auto res = (len / 3u + 1u) * 4u;
+    auto res = out_buffer.size() + (len / 3u + 1u) * 4u;
     out_buffer.reserve(res);
     unsigned char const* p = reinterpret_cast<const unsigned char*>(data.data());
     while (len > 0) {
@@ -101,10 +108,23 @@ Pl_Base64::encode_internal(std::string_view data)
         ++p;
         --len;
     }
-    if (pos > 0) {
+    qpdf_assert_debug(out_buffer.size() <= res);
+}
+
+void
+Pl_Base64::finish_internal()
+{
+    if (pos == 0) {
+        return;
+    }
+    if (action == a_decode) {
+        for (size_t i = pos; i < 4; ++i) {
+            buf[i] = '=';
+        }
+        flush_decode();
+    } else {
         flush_encode();
     }
-    qpdf_assert_debug(out_buffer.size() <= res);
 }
 
 void
@@ -186,16 +206,12 @@ Pl_Base64::flush_encode()
 void
 Pl_Base64::finish()
 {
-    if (action == a_decode) {
-        decode_internal(in_buffer);
-
-    } else {
-        encode_internal(in_buffer);
-    }
+    finish_internal();
     if (next()) {
-        in_buffer.clear();
-        in_buffer.shrink_to_fit();
-        next()->write(reinterpret_cast<unsigned char const*>(out_buffer.data()), out_buffer.size());
+        if (!out_buffer.empty()) {
+            next()->write(
+                reinterpret_cast<unsigned char const*>(out_buffer.data()), out_buffer.size());
+        }
         out_buffer.clear();
         out_buffer.shrink_to_fit();
         next()->finish();
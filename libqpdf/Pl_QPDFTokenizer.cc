@@ -1,13 +1,85 @@
 #include <qpdf/Pl_QPDFTokenizer.hh>
 
 #include <qpdf/InputSource_private.hh>
-#include <qpdf/Pipeline_private.hh>
 #include <qpdf/QTC.hh>
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace qpdf;
 
+namespace
+{
+    // An input source over the data received so far that records whether the tokenizer has
+    // looked at the end of the data. A token that was read without reaching the end would be the
+    // same however much more data followed, so it can be passed on before the rest of the data is
+    // written.
+    class Available final: public InputSource
+    {
+      public:
+        Available(std::string_view data) :
+            input("tokenizer data", data),
+            size(static_cast<qpdf_offset_t>(data.size()))
+        {
+        }
+
+        ~Available() final = default;
+
+        qpdf_offset_t
+        findAndSkipNextEOL() final
+        {
+            auto result = input.findAndSkipNextEOL();
+            at_end = at_end || input.tell() >= size;
+            return result;
+        }
+
+        std::string const&
+        getName() const final
+        {
+            return input.getName();
+        }
+
+        qpdf_offset_t
+        tell() final
+        {
+            return input.tell();
+        }
+
+        void
+        seek(qpdf_offset_t offset, int whence) final
+        {
+            input.seek(offset, whence);
+        }
+
+        void
+        rewind() final
+        {
+            input.rewind();
+        }
+
+        size_t
+        read(char* buffer, size_t length) final
+        {
+            auto result = input.read(buffer, length);
+            last_offset = input.getLastOffset();
+            at_end = at_end || result < length;
+            return result;
+        }
+
+        void
+        unreadCh(char ch) final
+        {
+            input.unreadCh(ch);
+        }
+
+        bool at_end{false};
+
+      private:
+        is::OffsetBuffer input;
+        qpdf_offset_t size;
+    };
+} // namespace
+
 class Pl_QPDFTokenizer::Members
 {
   public:
@@ -15,10 +87,16 @@ class Pl_QPDFTokenizer::Members
     Members(Members const&) = delete;
     ~Members() = default;
 
+    void tokenize(bool finishing);
+
     QPDFObjectHandle::TokenFilter* filter{nullptr};
     QPDFTokenizer tokenizer;
+    // Data that has been written but not yet passed to the filter as part of a token.
     std::string buffer;
-    pl::String buf{"pl_tokenizer", nullptr, buffer};
+    // Don't tokenize again until the buffer has reached this size. Waiting for a reasonable amount
+    // of new data avoids rereading the incomplete token at the end of the buffer after every small
+    // write, and waiting for the buffer to double keeps the work linear for very large tokens.
+    size_t retry_size{0};
 };
 
 Pl_QPDFTokenizer::Pl_QPDFTokenizer(
@@ -38,30 +116,65 @@ Pl_QPDFTokenizer::~Pl_QPDFTokenizer() = default;
 void
 Pl_QPDFTokenizer::write(unsigned char const* data, size_t len)
 {
-    m->buf.write(data, len);
+    m->buffer.append(reinterpret_cast<char const*>(data), len);
+    if (m->buffer.size() >= m->retry_size) {
+        m->tokenize(false);
+        m->retry_size = std::max(2 * m->buffer.size(), m->buffer.size() + 4096);
+    }
 }
 
 void
-Pl_QPDFTokenizer::finish()
+Pl_QPDFTokenizer::Members::tokenize(bool finishing)
 {
-    auto input = is::OffsetBuffer("tokenizer data", m->buffer);
+    // Pass on every token that is known to be complete, and keep the rest of the data until more
+    // is written. Until finishing, a token whose reading reached the end of the data may continue
+    // in the next write, so it is read again once there is more data. An inline image, together
+    // with the ID and the space preceding it, is handled as a unit because finding its end
+    // requires looking at the tokens that follow it. This keeps the amount of buffered data
+    // bounded by the size of the largest token rather than the size of the content stream.
+    Available input(buffer);
     std::string empty;
+    qpdf_offset_t done = 0;
     while (true) {
-        auto token = m->tokenizer.readToken(input, empty, true);
-        m->filter->handleToken(token);
+        auto token = tokenizer.readToken(input, empty, true);
+        if (!finishing && input.at_end) {
+            break;
+        }
         if (token.getType() == QPDFTokenizer::tt_eof) {
+            filter->handleToken(token);
+            done = input.tell();
             break;
         } else if (token.isWord("ID")) {
             // Read the space after the ID.
             char ch = ' ';
             input.read(&ch, 1);
-            m->filter->handleToken(
+            tokenizer.expectInlineImage(input);
+            auto image = tokenizer.readToken(input, empty, true);
+            if (!finishing && input.at_end) {
+                break;
+            }
+            filter->handleToken(token);
+            filter->handleToken(
                 // line-break
                 QPDFTokenizer::Token(QPDFTokenizer::tt_space, std::string(1, ch)));
             QTC::TC("qpdf", "Pl_QPDFTokenizer found ID");
-            m->tokenizer.expectInlineImage(input);
+            filter->handleToken(image);
+            if (image.getType() == QPDFTokenizer::tt_eof) {
+                done = input.tell();
+                break;
+            }
+        } else {
+            filter->handleToken(token);
         }
+        done = input.tell();
     }
+    buffer.erase(0, static_cast<size_t>(done));
+}
+
+void
+Pl_QPDFTokenizer::finish()
+{
+    m->tokenize(true);
     m->filter->handleEOF();
     QPDFObjectHandle::TokenFilter::PipelineAccessor::setPipeline(m->filter, nullptr);
     if (next()) {
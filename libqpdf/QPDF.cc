@@ -312,9 +312,37 @@ QPDF::setImmediateCopyFrom(bool val)
     (void)m->cf.immediate_copy_from(val);
 }
 
+void
+QPDF::setPagesTreeFanout(size_t fanout)
+{
+    if (fanout == 1 || fanout == 2) {
+        throw std::invalid_argument("QPDF::setPagesTreeFanout: fanout must be 0 or at least 3");
+    }
+    (void)m->cf.pages_tree_fanout(fanout);
+}
+
+void
+QPDF::setXRefIndexFile(std::string const& filename)
+{
+    (void)m->cf.xref_index_file(filename);
+}
+
+void
+QPDF::setXRefReconstructionThreads(size_t threads)
+{
+    (void)m->cf.threads(threads);
+}
+
+bool
+QPDF::usedXRefIndexFile() const
+{
+    return m->objects.used_xref_index();
+}
+
 std::vector<QPDFExc>
 QPDF::getWarnings()
 {
+    std::lock_guard lock(m->warnings_mutex);
     std::vector<QPDFExc> result = std::move(m->warnings);
     m->warnings.clear();
     return result;
@@ -341,6 +369,7 @@ QPDF::warn(QPDFExc const& e)
 void
 Common::warn(QPDFExc const& e)
 {
+    std::lock_guard lock(m->warnings_mutex);
     if (cf.max_warnings() > 0 && m->warnings.size() >= cf.max_warnings()) {
         stopOnError("Too many warnings - file is too badly damaged");
     }
@@ -713,13 +742,22 @@ QPDF::pipeStreamData(
 {
     std::unique_ptr<Pipeline> to_delete;
     if (encp->encrypted) {
+        // The encryption key cache is shared by all threads reading from a read-only snapshot.
+        std::lock_guard lock(qpdf_for_warning.m->encryption_mutex);
         decryptStream(
             encp, file, qpdf_for_warning, pipeline, og, stream_dict, is_root_metadata, to_delete);
     }
 
     bool attempted_finish = false;
     try {
-        auto buf = file->read(length, offset);
+        // The data is read with a positional read, so several threads can pipe stream data from a
+        // read-only snapshot at the same time.
+        std::string buf(length, '\0');
+        buf.resize(file->readAt(offset, buf.data(), length));
+        if (!qpdf_for_warning.m->read_only_snapshot) {
+            // Offsets in subsequent error messages refer to the stream data.
+            file->setLastOffset(offset);
+        }
         if (buf.size() != length) {
             throw qpdf_for_warning.m->c.damagedPDF(
                 *file,
@@ -743,7 +781,7 @@ QPDF::pipeStreamData(
                 qpdf_for_warning.m->c.damagedPDF(
                     *file,
                     "",
-                    file->getLastOffset(),
+                    offset,
                     ("error decoding stream data for object " + og.unparse(' ') + ": " +
                      e.what())));
             if (will_retry) {
@@ -752,7 +790,7 @@ QPDF::pipeStreamData(
                     qpdf_for_warning.m->c.damagedPDF(
                         *file,
                         "",
-                        file->getLastOffset(),
+                        offset,
                         "stream will be re-processed without filtering to avoid data loss"));
             }
         }
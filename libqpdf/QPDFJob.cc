@@ -26,6 +26,7 @@
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
+#include <qpdf/WorkerPool.hh>
 #include <qpdf/global_private.hh>
 
 #include <qpdf/auto_job_schema.hh> // JOB_SCHEMA_DATA
@@ -36,32 +37,85 @@ using Pages = impl::Doc::Pages;
 
 namespace
 {
-    class ImageOptimizer final: public QPDFObjectHandle::StreamDataProvider
+    // Optimizes a single image. prepare and finish access the image and must be called from the
+    // thread that uses its QPDF. compress only works on the data read by prepare and may be called
+    // from any thread, which allows the expensive JPEG compression of many images to be done
+    // concurrently.
+    class ImageOptimizer final
     {
       public:
         ImageOptimizer(
-            QPDFJob& o,
             size_t oi_min_width,
             size_t oi_min_height,
             size_t oi_min_area,
             int quality,
-            QPDFObjectHandle& image);
-        ~ImageOptimizer() final = default;
-        void provideStreamData(QPDFObjGen const&, Pipeline* pipeline) final;
-        bool evaluate(std::string const& description);
+            QPDFObjectHandle const& image);
+        ~ImageOptimizer() = default;
+
+        // Check whether the image can be optimized and read its decoded data.
+        bool prepare();
+        void compress();
+        // Create the optimized image if compression reduced the size of the image.
+        void finish(QPDF& pdf);
+
+        bool
+        finished() const
+        {
+            return finished_;
+        }
+
+        // The outcome for reporting in verbose mode, or empty if there is nothing to report
+        std::string const&
+        message() const
+        {
+            return message_;
+        }
+
+        // The replacement image, or null if the image is not being optimized
+        QPDFObjectHandle const&
+        optimized() const
+        {
+            return optimized_;
+        }
 
       private:
-        std::unique_ptr<Pipeline> makePipeline(std::string const& description, Pipeline* next);
+        bool check();
 
-        QPDFJob& o;
         size_t oi_min_width;
         size_t oi_min_height;
         size_t oi_min_area;
         qpdf_stream_decode_level_e decode_level{qpdf_dl_specialized};
         QPDFObjectHandle image;
         std::shared_ptr<Pl_DCT::CompressConfig> config;
+        JDIMENSION width{0};
+        JDIMENSION height{0};
+        int components{0};
+        J_COLOR_SPACE color_space{JCS_UNKNOWN};
+        bool prepared{false};
+        bool finished_{false};
+        std::string data;
+        std::string error;
+        std::string message_;
+        QPDFObjectHandle optimized_;
     };
 
+    // Prepare images serially and compress them concurrently, in batches of one image per thread
+    // so that not more than that many decoded images are held in memory at once.
+    void
+    optimize_images(std::vector<ImageOptimizer*>& images, WorkerPool& pool)
+    {
+        for (size_t start = 0; start < images.size(); start += pool.size()) {
+            std::vector<ImageOptimizer*> batch;
+            for (size_t i = start; i < std::min(start + pool.size(), images.size()); ++i) {
+                if (images[i]->prepare()) {
+                    batch.emplace_back(images[i]);
+                }
+            }
+            pool.run(batch.size(), [&batch](size_t i) { batch[i]->compress(); });
+        }
+        images.clear();
+    }
+
     class ProgressReporter final: public QPDFWriter::ProgressReporter
     {
       public:
@@ -86,13 +140,11 @@ namespace
 } // namespace
 
 ImageOptimizer::ImageOptimizer(
-    QPDFJob& o,
     size_t oi_min_width,
     size_t oi_min_height,
     size_t oi_min_area,
     int quality,
-    QPDFObjectHandle& image) :
-    o(o),
+    QPDFObjectHandle const& image) :
     oi_min_width(oi_min_width),
     oi_min_height(oi_min_height),
     oi_min_area(oi_min_area),
@@ -106,134 +158,122 @@ ImageOptimizer::ImageOptimizer(
     }
 }
 
-std::unique_ptr<Pipeline>
-ImageOptimizer::makePipeline(std::string const& description, Pipeline* next)
+bool
+ImageOptimizer::check()
 {
     QPDFObjectHandle dict = image.getDict();
     QPDFObjectHandle w_obj = dict.getKey("/Width");
     QPDFObjectHandle h_obj = dict.getKey("/Height");
     QPDFObjectHandle colorspace_obj = dict.getKey("/ColorSpace");
     if (!(w_obj.isNumber() && h_obj.isNumber())) {
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image dictionary is missing required keys\n";
-            });
-        }
-        return {};
+        message_ = "not optimizing because image dictionary is missing required keys";
+        return false;
     }
     QPDFObjectHandle components_obj = dict.getKey("/BitsPerComponent");
     if (!(components_obj.isInteger() && components_obj.getIntValue() == 8)) {
         QTC::TC("qpdf", "QPDFJob image optimize bits per component");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image has other than 8 bits per component\n";
-            });
-        }
-        return {};
+        message_ = "not optimizing because image has other than 8 bits per component";
+        return false;
     }
     // Files have been seen in the wild whose width and height are floating point, which is goofy,
     // but we can deal with it.
-    JDIMENSION w = 0;
     if (w_obj.isInteger()) {
-        w = w_obj.getUIntValueAsUInt();
+        width = w_obj.getUIntValueAsUInt();
     } else {
-        w = static_cast<JDIMENSION>(w_obj.getNumericValue());
+        width = static_cast<JDIMENSION>(w_obj.getNumericValue());
     }
-    JDIMENSION h = 0;
     if (h_obj.isInteger()) {
-        h = h_obj.getUIntValueAsUInt();
+        height = h_obj.getUIntValueAsUInt();
     } else {
-        h = static_cast<JDIMENSION>(h_obj.getNumericValue());
+        height = static_cast<JDIMENSION>(h_obj.getNumericValue());
     }
     std::string colorspace = (colorspace_obj.isName() ? colorspace_obj.getName() : std::string());
-    int components = 0;
-    J_COLOR_SPACE cs = JCS_UNKNOWN;
     if (colorspace == "/DeviceRGB") {
         components = 3;
-        cs = JCS_RGB;
+        color_space = JCS_RGB;
     } else if (colorspace == "/DeviceGray") {
         components = 1;
-        cs = JCS_GRAYSCALE;
+        color_space = JCS_GRAYSCALE;
     } else if (colorspace == "/DeviceCMYK") {
         components = 4;
-        cs = JCS_CMYK;
+        color_space = JCS_CMYK;
     } else {
         QTC::TC("qpdf", "QPDFJob image optimize colorspace");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because qpdf can't optimize images with this colorspace\n";
-            });
-        }
-        return {};
+        message_ = "not optimizing because qpdf can't optimize images with this colorspace";
+        return false;
     }
-    if ((oi_min_width > 0 && w <= oi_min_width) || (oi_min_height > 0 && h <= oi_min_height) ||
-        (oi_min_area > 0 && (w * h) <= oi_min_area)) {
+    if ((oi_min_width > 0 && width <= oi_min_width) ||
+        (oi_min_height > 0 && height <= oi_min_height) ||
+        (oi_min_area > 0 && (width * height) <= oi_min_area)) {
         QTC::TC("qpdf", "QPDFJob image optimize too small");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image is smaller than requested minimum "
-                     "dimensions\n";
-            });
-        }
-        return {};
+        message_ = "not optimizing because image is smaller than requested minimum dimensions";
+        return false;
     }
-
-    return std::make_unique<Pl_DCT>("jpg", next, w, h, components, cs, config.get());
+    return true;
 }
 
 bool
-ImageOptimizer::evaluate(std::string const& description)
+ImageOptimizer::prepare()
 {
     // Note: passing nullptr as pipeline (first argument) just tests whether we can filter.
     if (!image.pipeStreamData(nullptr, 0, decode_level, true)) {
         QTC::TC("qpdf", "QPDFJob image optimize no pipeline");
-        o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": " << description
-              << ": not optimizing because unable to decode data or data already uses DCT\n";
-        });
+        message_ = "not optimizing because unable to decode data or data already uses DCT";
         return false;
     }
-    pl::Count c(0);
-    auto p = makePipeline(description, &c);
-    if (!p) {
-        // message issued by makePipeline
+    if (!check()) {
         return false;
     }
-    if (!image.pipeStreamData(p.get(), 0, decode_level)) {
-        return false;
+    pl::String p("image data", nullptr, data);
+    prepared = image.pipeStreamData(&p, 0, decode_level);
+    if (!prepared) {
+        data.clear();
     }
-    long long orig_length = image.getDict().getKey("/Length").getIntValue();
-    if (c.getCount() >= orig_length) {
-        QTC::TC("qpdf", "QPDFJob image optimize no shrink");
-        o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": " << description
-              << ": not optimizing because DCT compression does not reduce image size\n";
-        });
-        return false;
+    return prepared;
+}
+
+void
+ImageOptimizer::compress()
+{
+    std::string decoded;
+    decoded.swap(data);
+    try {
+        pl::String s("optimized image", nullptr, data);
+        Pl_DCT p("jpg", &s, width, height, components, color_space, config.get());
+        p.write(reinterpret_cast<unsigned char const*>(decoded.data()), decoded.size());
+        p.finish();
+    } catch (std::exception& e) {
+        error = e.what();
+        data.clear();
     }
-    o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-        v << prefix << ": " << description << ": optimizing image reduces size from " << orig_length
-          << " to " << c.getCount() << "\n";
-    });
-    return true;
 }
 
 void
-ImageOptimizer::provideStreamData(QPDFObjGen const&, Pipeline* pipeline)
-{
-    auto p = makePipeline("", pipeline);
-    if (!p) {
-        // Should not be possible
-        image.warnIfPossible(
-            "unable to create pipeline after previous success; image data will be lost");
-        pipeline->finish();
+ImageOptimizer::finish(QPDF& pdf)
+{
+    finished_ = true;
+    if (!prepared) {
+        // message issued by prepare if there is one
+        return;
+    }
+    if (!error.empty()) {
+        image.warnIfPossible("error optimizing image: " + error);
         return;
     }
-    image.pipeStreamData(p.get(), 0, decode_level, false, false);
+    long long orig_length = image.getDict().getKey("/Length").getIntValue();
+    if (QIntC::to_longlong(data.size()) >= orig_length) {
+        QTC::TC("qpdf", "QPDFJob image optimize no shrink");
+        message_ = "not optimizing because DCT compression does not reduce image size";
+        return;
+    }
+    message_ = "optimizing image reduces size from " + std::to_string(orig_length) + " to " +
+        std::to_string(data.size());
+    optimized_ = pdf.newStream();
+    optimized_.replaceDict(image.getDict().shallowCopy());
+    optimized_.replaceStreamData(
+        data, QPDFObjectHandle::newName("/DCTDecode"), QPDFObjectHandle::newNull());
+    data.clear();
+    data.shrink_to_fit();
 }
 
 // Page number (1 based) and index (0 based). Defaults to page number 1 / index 0.
@@ -959,15 +999,14 @@ QPDFJob::doJSONObjects(Pipeline* p, bool& first, QPDF& pdf)
         bool first_object = true;
         JSON::writeDictionaryOpen(p, first_object, 1);
         bool all_objects = m->json_objects.empty();
-        auto wanted_og = getWantedJSONObjects();
-        for (auto& obj: pdf.getAllObjects()) {
-            std::string key = obj.unparse();
-
-            if (all_objects || wanted_og.contains(obj.getObjGen())) {
-                JSON::writeDictionaryKey(p, first_object, obj.unparse(), 2);
-                obj.writeJSON(1, p, true, 2);
-                first_object = false;
-            }
+        // Only read the selected objects so that selecting a few objects from a large file is
+        // fast.
+        auto objects = all_objects ? pdf.getAllObjects()
+                                   : pdf.doc().objects().select(getWantedJSONObjects());
+        for (auto& obj: objects) {
+            JSON::writeDictionaryKey(p, first_object, obj.unparse(), 2);
+            obj.writeJSON(1, p, true, 2);
+            first_object = false;
         }
         if (all_objects || m->json_objects.contains("trailer")) {
             JSON::writeDictionaryKey(p, first_object, "trailer", 2);
@@ -1001,24 +1040,22 @@ QPDFJob::doJSONObjectinfo(Pipeline* p, bool& first, QPDF& pdf)
     JSON::writeDictionaryKey(p, first, "objectinfo", 1);
     bool first_object = true;
     JSON::writeDictionaryOpen(p, first_object, 1);
-    bool all_objects = m->json_objects.empty();
-    auto wanted_og = getWantedJSONObjects();
-    for (auto& obj: pdf.getAllObjects()) {
-        if (all_objects || wanted_og.contains(obj.getObjGen())) {
-            auto j_details = JSON::makeDictionary();
-            auto j_stream = j_details.addDictionaryMember("stream", JSON::makeDictionary());
-            bool is_stream = obj.isStream();
-            j_stream.addDictionaryMember("is", JSON::makeBool(is_stream));
-            j_stream.addDictionaryMember(
-                "length",
-                (is_stream ? obj.getDict().getKey("/Length").getJSON(m->json_version, true)
-                           : JSON::makeNull()));
-            j_stream.addDictionaryMember(
-                "filter",
-                (is_stream ? obj.getDict().getKey("/Filter").getJSON(m->json_version, true)
-                           : JSON::makeNull()));
-            JSON::writeDictionaryItem(p, first_object, obj.unparse(), j_details, 2);
-        }
+    auto objects = m->json_objects.empty() ? pdf.getAllObjects()
+                                           : pdf.doc().objects().select(getWantedJSONObjects());
+    for (auto& obj: objects) {
+        auto j_details = JSON::makeDictionary();
+        auto j_stream = j_details.addDictionaryMember("stream", JSON::makeDictionary());
+        bool is_stream = obj.isStream();
+        j_stream.addDictionaryMember("is", JSON::makeBool(is_stream));
+        j_stream.addDictionaryMember(
+            "length",
+            (is_stream ? obj.getDict().getKey("/Length").getJSON(m->json_version, true)
+                       : JSON::makeNull()));
+        j_stream.addDictionaryMember(
+            "filter",
+            (is_stream ? obj.getDict().getKey("/Filter").getJSON(m->json_version, true)
+                       : JSON::makeNull()));
+        JSON::writeDictionaryItem(p, first_object, obj.unparse(), j_details, 2);
     }
     JSON::writeDictionaryClose(p, first_object, 1);
 }
@@ -1333,6 +1370,31 @@ QPDFJob::doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf)
     JSON::writeDictionaryItem(p, first, "attachments", j_attachments, 1);
 }
 
+void
+QPDFJob::doJSONStreamDigests(Pipeline* p, bool& first, QPDF& pdf)
+{
+    JSON::writeDictionaryKey(p, first, "streamdigests", 1);
+    bool first_object = true;
+    JSON::writeDictionaryOpen(p, first_object, 1);
+    auto objects = m->json_objects.empty() ? pdf.getAllObjects()
+                                           : pdf.doc().objects().select(getWantedJSONObjects());
+    auto null_or_string = [](bool present, std::string const& s) {
+        return present ? JSON::makeString(s) : JSON::makeNull();
+    };
+    auto digests = pdf.getStreamDigests(objects, m->w_cfg.decode_level(), m->d_cfg.threads());
+    for (auto const& [og, d]: digests) {
+        auto j_details = JSON::makeDictionary();
+        j_details.addDictionaryMember("rawmd5", JSON::makeString(d.raw_md5));
+        j_details.addDictionaryMember("rawsha256", JSON::makeString(d.raw_sha256));
+        j_details.addDictionaryMember("md5", null_or_string(d.decoded, d.decoded_md5));
+        j_details.addDictionaryMember("sha256", null_or_string(d.decoded, d.decoded_sha256));
+        auto key = og.unparse(' ') + " R";
+        JSON::writeDictionaryItem(
+            p, first_object, m->json_version == 1 ? key : "obj:" + key, j_details, 2);
+    }
+    JSON::writeDictionaryClose(p, first_object, 1);
+}
+
 JSON
 QPDFJob::json_schema(int json_version, std::set<std::string>* keys)
 {
@@ -1508,6 +1570,15 @@ QPDFJob::json_schema(int json_version, std::set<std::string>* keys)
       }
     })";
 
+    static constexpr const char* streamdigests_schema = R"({
+      "<object-id>": {
+        "rawmd5": "MD5 digest of the raw stream data",
+        "rawsha256": "SHA-256 digest of the raw stream data",
+        "md5": "MD5 digest of the stream data decoded at the decode level, or null if it can't be decoded",
+        "sha256": "SHA-256 digest of the stream data decoded at the decode level, or null if it can't be decoded"
+      }
+    })";
+
     JSON schema = JSON::makeDictionary();
     schema.addDictionaryMember(
         "version",
@@ -1541,6 +1612,10 @@ QPDFJob::json_schema(int json_version, std::set<std::string>* keys)
         (json_version == 1 ? "moddifyannotations" : "modifyannotations");
     add_if_want_key("encrypt", encrypt_schema1 + MODIFY_ANNOTATIONS + encrypt_schema2);
     add_if_want_key("attachments", attachments_schema);
+    // "streamdigests" requires reading all stream data, so it is only included when requested.
+    if (!keys || keys->contains("streamdigests")) {
+        (void)schema.addDictionaryMember("streamdigests", JSON::parse(streamdigests_schema));
+    }
 
     return schema;
 }
@@ -1632,6 +1707,9 @@ QPDFJob::doJSON(QPDF& pdf, Pipeline* p)
     if (want_key("outlines")) {
         doJSONOutlines(p, first, pdf);
     }
+    if (m->json_keys.contains("streamdigests")) {
+        doJSONStreamDigests(p, first, pdf);
+    }
 
     // We do objects last so their information is consistent with repairing the page tree. To see
     // the original file with any page tree problems and the page tree not flattened, select
@@ -2129,30 +2207,61 @@ QPDFJob::handleTransformations(QPDF& pdf)
         }
     }
     if (m->optimize_images) {
+        // Find all the images first so that they can be optimized concurrently, and then replace
+        // them in the order in which they were found. Each image is optimized once no matter how
+        // many times it is used. An image may have been replaced by an earlier replacement in a
+        // shared resource dictionary by the time it is reached, in which case the replacement is
+        // considered instead, just as if images had been replaced as they were found.
+        struct Use
+        {
+            QPDFObjectHandle xobj_dict;
+            std::string key;
+            std::string description;
+        };
+        std::vector<Use> uses;
+        std::map<QPDFObjGen, ImageOptimizer> optimizers;
+        std::vector<ImageOptimizer*> pending;
+        WorkerPool pool(m->d_cfg.threads());
+        auto optimizer = [this, &optimizers, &pending](QPDFObjectHandle const& image) {
+            auto [it, inserted] = optimizers.try_emplace(
+                image.getObjGen(),
+                m->oi_min_width,
+                m->oi_min_height,
+                m->oi_min_area,
+                m->jpeg_quality,
+                image);
+            if (inserted) {
+                pending.emplace_back(&it->second);
+            }
+            return &it->second;
+        };
         int pageno = 0;
         for (auto& ph: dh.getAllPages()) {
             ++pageno;
             ph.forEachImage(
                 true,
-                [this, pageno, &pdf](
+                [pageno, &uses, &optimizer](
                     QPDFObjectHandle& obj, QPDFObjectHandle& xobj_dict, std::string const& key) {
-                    auto io = std::make_unique<ImageOptimizer>(
-                        *this,
-                        m->oi_min_width,
-                        m->oi_min_height,
-                        m->oi_min_area,
-                        m->jpeg_quality,
-                        obj);
-                    if (io->evaluate("image " + key + " on page " + std::to_string(pageno))) {
-                        QPDFObjectHandle new_image = pdf.newStream();
-                        new_image.replaceDict(obj.getDict().shallowCopy());
-                        new_image.replaceStreamData(
-                            std::move(io),
-                            QPDFObjectHandle::newName("/DCTDecode"),
-                            QPDFObjectHandle::newNull());
-                        xobj_dict.replaceKey(key, new_image);
-                    }
+                    uses.emplace_back(
+                        xobj_dict, key, "image " + key + " on page " + std::to_string(pageno));
+                    optimizer(obj);
+                });
+        }
+        optimize_images(pending, pool);
+        for (auto& use: uses) {
+            auto io = optimizer(use.xobj_dict.getKey(use.key));
+            optimize_images(pending, pool);
+            if (!io->finished()) {
+                io->finish(pdf);
+            }
+            if (!io->message().empty()) {
+                doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                    v << prefix << ": " << use.description << ": " << io->message() << "\n";
                 });
+            }
+            if (io->optimized()) {
+                use.xobj_dict.replaceKey(use.key, io->optimized());
+            }
         }
     }
     if (m->generate_appearances) {
@@ -2228,6 +2337,14 @@ QPDFJob::handleTransformations(QPDF& pdf)
 
 bool
 QPDFJob::shouldRemoveUnreferencedResources(QPDF& pdf)
+{
+    return shouldRemoveUnreferencedResources(pdf, {pdf.getRoot().getKey("/Pages")});
+}
+
+// Check for shared resources starting from the given pages tree nodes. With --lazy-page-access,
+// only the pages that are actually being copied are checked.
+bool
+QPDFJob::shouldRemoveUnreferencedResources(QPDF& pdf, std::vector<QPDFObjectHandle> const& nodes)
 {
     if (m->remove_unreferenced_page_resources == QPDFJob::re_no) {
         return false;
@@ -2250,8 +2367,7 @@ QPDFJob::shouldRemoveUnreferencedResources(QPDF& pdf)
         v << prefix << ": " << pdf.getFilename() << ": checking for shared resources\n";
     });
 
-    std::list<QPDFObjectHandle> queue;
-    queue.emplace_back(pdf.getRoot().getKey("/Pages"));
+    std::list<QPDFObjectHandle> queue(nodes.begin(), nodes.end());
     while (!queue.empty()) {
         QPDFObjectHandle node = *queue.begin();
         queue.pop_front();
@@ -2340,12 +2456,17 @@ QPDFJob::Input::initialize(QPDFJob& job, Inputs& in, QPDF* a_qpdf)
     qpdf = a_qpdf ? a_qpdf : qpdf_p.get();
     if (qpdf) {
         auto& doc = qpdf->doc();
-        orig_pages = doc.pages().all();
-        n_pages = static_cast<int>(orig_pages.size());
-        copied_pages = std::vector<bool>(orig_pages.size(), false);
-
-        if (job.m->remove_unreferenced_page_resources != QPDFJob::re_no) {
-            remove_unreferenced = job.shouldRemoveUnreferencedResources(*qpdf);
+        // All pages of the primary input are needed to remove the ones that are not selected. Other
+        // inputs are only read as far as necessary to locate the selected pages.
+        auto n = in.lazy_page_access && !a_qpdf ? doc.pages().declared_size() : 0;
+        if (n > 0 && std::cmp_less_equal(n, std::numeric_limits<int>::max())) {
+            doc.pages().lazy(true);
+            lazy = true;
+            orig_pages = std::vector<QPDFObjectHandle>(n);
+            n_pages = static_cast<int>(n);
+            copied_pages = std::vector<bool>(n, false);
+        } else {
+            load_all(job);
         }
         if (doc.page_labels().hasPageLabels()) {
             in.any_page_labels = true;
@@ -2353,6 +2474,38 @@ QPDFJob::Input::initialize(QPDFJob& job, Inputs& in, QPDF* a_qpdf)
     }
 }
 
+void
+QPDFJob::Input::load_all(QPDFJob& job)
+{
+    auto& pages = qpdf->doc().pages();
+    pages.lazy(false);
+    lazy = false;
+    orig_pages = pages.all();
+    n_pages = static_cast<int>(orig_pages.size());
+    copied_pages = std::vector<bool>(orig_pages.size(), false);
+
+    if (job.m->remove_unreferenced_page_resources != QPDFJob::re_no) {
+        remove_unreferenced = job.shouldRemoveUnreferencedResources(*qpdf);
+    }
+}
+
+// Locate the given pages of a lazy input. Return false if any of them can't be located without
+// traversing the entire pages tree.
+bool
+QPDFJob::Input::locate(std::vector<int> const& pagenos)
+{
+    for (PageNo page: pagenos) {
+        auto& oh = orig_pages.at(page.idx);
+        if (!oh) {
+            oh = qpdf->doc().pages().locate(page.idx);
+            if (!oh) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 void
 QPDFJob::Inputs::infile_name(std::string const& name)
 {
@@ -2432,26 +2585,59 @@ QPDFJob::Inputs::process_all(QPDFJob& job)
             process(job, filename, input);
         }
 
+        auto select_pages = [&]() {
+            for (auto& selection: selections) {
+                if (&selection.input() != &input) {
+                    continue;
+                }
+                // Read original pages from the PDF, and parse the page range associated with this
+                // occurrence of the file.
+                if (selection.range.empty()) {
+                    selection.selected_pages.clear();
+                    selection.selected_pages.reserve(static_cast<size_t>(input.n_pages));
+                    for (int i = 1; i <= input.n_pages; ++i) {
+                        selection.selected_pages.push_back(i);
+                    }
+                    continue;
+                }
+                try {
+                    selection.selected_pages =
+                        QUtil::parse_numrange(selection.range.data(), selection.input().n_pages);
+                } catch (std::runtime_error& e) {
+                    throw std::runtime_error(
+                        "parsing numeric range for " + selection.filename() + ": " + e.what());
+                }
+            }
+        };
+        select_pages();
+
+        if (!input.lazy) {
+            continue;
+        }
+        bool located = true;
         for (auto& selection: selections) {
-            if (&selection.input() != &input) {
-                continue;
+            if (&selection.input() == &input && !input.locate(selection.selected_pages)) {
+                located = false;
+                break;
             }
-            // Read original pages from the PDF, and parse the page range associated with this
-            // occurrence of the file.
-            if (selection.range.empty()) {
-                selection.selected_pages.reserve(static_cast<size_t>(input.n_pages));
-                for (int i = 1; i <= input.n_pages; ++i) {
-                    selection.selected_pages.push_back(i);
+        }
+        if (!located) {
+            // The page count used to parse the ranges may be wrong as well.
+            job.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": " << filename
+                  << ": unable to locate pages individually; reading all pages\n";
+            });
+            input.load_all(job);
+            select_pages();
+        } else if (job.m->remove_unreferenced_page_resources != QPDFJob::re_no) {
+            std::vector<QPDFObjectHandle> located_pages;
+            for (auto const& page: input.orig_pages) {
+                if (page) {
+                    located_pages.emplace_back(page);
                 }
-                continue;
-            }
-            try {
-                selection.selected_pages =
-                    QUtil::parse_numrange(selection.range.data(), selection.input().n_pages);
-            } catch (std::runtime_error& e) {
-                throw std::runtime_error(
-                    "parsing numeric range for " + selection.filename() + ": " + e.what());
             }
+            input.remove_unreferenced =
+                job.shouldRemoveUnreferencedResources(*input.qpdf, located_pages);
         }
     }
 }
@@ -2647,6 +2833,14 @@ QPDFJob::handlePageSpecs(QPDF& pdf)
     if (m->inputs.any_page_labels) {
         pdf.getRoot().replaceKey("/PageLabels", Dictionary({{"/Nums", Array(new_labels)}}));
     }
+    for (auto& [filename, input]: m->inputs.files) {
+        if (input.lazy) {
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": " << filename << ": " << input.qpdf->getResolvedObjectCount()
+                  << " objects resolved\n";
+            });
+        }
+    }
 
     // Delete page objects for unused page in primary. This prevents those objects from being
     // preserved by being referred to from other places, such as the outlines dictionary. Also make
@@ -3064,6 +3258,17 @@ QPDFJob::writeOutfile(QPDF& pdf)
         }
         setWriterOptions(w);
         w.write();
+        if (m->w_cfg.deduplicate_streams()) {
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": deduplicated " << w.getDeduplicatedStreamCount()
+                  << " streams, saving " << w.getDeduplicatedStreamBytes() << " bytes\n";
+            });
+        }
+        if (m->w_cfg.deduplicate_objects()) {
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": deduplicated " << w.getDeduplicatedObjectCount() << " objects\n";
+            });
+        }
     }
     if (!m->outfilename.empty()) {
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
@@ -414,6 +414,13 @@ QPDFJob::Config::keepInlineImages()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::lazyPageAccess()
+{
+    o.m->inputs.lazy_page_access = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::linearize()
 {
@@ -499,6 +506,13 @@ QPDFJob::Config::optimizeImages()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::pagesTreeFanout(std::string const& parameter)
+{
+    o.m->w_cfg.pages_tree_fanout(to_uint32("pages-tree-fanout", parameter, 1'000'000, 3));
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::password(std::string const& parameter)
 {
@@ -520,6 +534,20 @@ QPDFJob::Config::preserveUnreferenced()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::deduplicateObjects()
+{
+    o.m->w_cfg.deduplicate_objects(true);
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::deduplicateStreams()
+{
+    o.m->w_cfg.deduplicate_streams(true);
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::preserveUnreferencedResources()
 {
@@ -716,6 +744,13 @@ QPDFJob::Config::suppressRecovery()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::threads(std::string const& parameter)
+{
+    o.m->d_cfg.threads(to_uint32("threads", parameter, 1'024));
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::verbose()
 {
@@ -562,7 +562,7 @@ BaseHandle::write_json(int json_version, JSON::Writer& p) const
         p << std::get<QPDF_Bool>(obj->value).val;
         break;
     case ::ot_integer:
-        p << std::to_string(std::get<QPDF_Integer>(obj->value).val);
+        p << std::get<QPDF_Integer>(obj->value).val;
         break;
     case ::ot_real:
         {
@@ -600,16 +600,16 @@ BaseHandle::write_json(int json_version, JSON::Writer& p) const
             // For performance reasons this code is duplicated in QPDF_Dictionary::writeJSON. When
             // updating this method make sure QPDF_Dictionary is also update.
             if (json_version == 1) {
-                p << "\"" << JSON::Writer::encode_string(Name::normalize(n.name)) << "\"";
+                p << "\"" << JSON::Writer::encoded(Name::normalize(n.name)) << "\"";
             } else {
                 if (auto res = Name::analyzeJSONEncoding(n.name); res.first) {
                     if (res.second) {
                         p << "\"" << n.name << "\"";
                     } else {
-                        p << "\"" << JSON::Writer::encode_string(n.name) << "\"";
+                        p << "\"" << JSON::Writer::encoded(n.name) << "\"";
                     }
                 } else {
-                    p << "\"n:" << JSON::Writer::encode_string(Name::normalize(n.name)) << "\"";
+                    p << "\"n:" << JSON::Writer::encoded(Name::normalize(n.name)) << "\"";
                 }
             }
         }
@@ -658,16 +658,16 @@ BaseHandle::write_json(int json_version, JSON::Writer& p) const
                 if (!iter.second.null()) {
                     p.writeNext();
                     if (json_version == 1) {
-                        p << "\"" << JSON::Writer::encode_string(Name::normalize(iter.first))
+                        p << "\"" << JSON::Writer::encoded(Name::normalize(iter.first))
                           << "\": ";
                     } else if (auto res = Name::analyzeJSONEncoding(iter.first); res.first) {
                         if (res.second) {
                             p << "\"" << iter.first << "\": ";
                         } else {
-                            p << "\"" << JSON::Writer::encode_string(iter.first) << "\": ";
+                            p << "\"" << JSON::Writer::encoded(iter.first) << "\": ";
                         }
                     } else {
-                        p << "\"n:" << JSON::Writer::encode_string(Name::normalize(iter.first))
+                        p << "\"n:" << JSON::Writer::encoded(Name::normalize(iter.first))
                           << "\": ";
                     }
                     iter.second.writeJSON(json_version, p);
@@ -2284,8 +2284,11 @@ QPDFObjectHandle::isPageObject() const
     if (!qpdf()) {
         return false;
     }
-    // getAllPages repairs /Type when traversing the page tree.
-    (void)qpdf()->doc().pages().all();
+    // getAllPages repairs /Type when traversing the page tree. In lazy mode, the /Pages nodes
+    // have been checked as they were visited.
+    if (auto& pages = qpdf()->doc().pages(); !pages.lazy()) {
+        (void)pages.all();
+    }
     return isDictionaryOfType("/Page");
 }
 
@@ -2295,8 +2298,11 @@ QPDFObjectHandle::isPagesObject() const
     if (!qpdf()) {
         return false;
     }
-    // getAllPages repairs /Type when traversing the page tree.
-    (void)qpdf()->doc().pages().all();
+    // getAllPages repairs /Type when traversing the page tree. In lazy mode, the /Pages nodes
+    // have been checked as they were visited.
+    if (auto& pages = qpdf()->doc().pages(); !pages.lazy()) {
+        (void)pages.all();
+    }
     return isDictionaryOfType("/Pages");
 }
 
@@ -4,10 +4,12 @@
 
 #include <qpdf/MD5.hh>
 #include <qpdf/Pl_AES_PDF.hh>
+#include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_Flate.hh>
 #include <qpdf/Pl_MD5.hh>
 #include <qpdf/Pl_PNGFilter.hh>
 #include <qpdf/Pl_RC4.hh>
+#include <qpdf/Pl_SHA2.hh>
 #include <qpdf/Pl_StdioFile.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
@@ -330,6 +332,7 @@ namespace qpdf::impl
         void enqueueObjectsPCLm();
         void enqueuePart(std::vector<QPDFObjectHandle>& part);
         void assignCompressedObjectNumbers(QPDFObjGen og);
+        void deduplicate();
         Dictionary trimmed_trailer();
 
         // Returns tuple<filter, compress_stream, is_root_metadata>
@@ -460,6 +463,9 @@ namespace qpdf::impl
         Pl_stack pipeline_stack;
         std::string deterministic_id_data;
         bool did_write_setup{false};
+        size_t deduplicated_streams{0};
+        size_t deduplicated_bytes{0};
+        size_t deduplicated_objects{0};
 
         // For progress reporting
         std::shared_ptr<QPDFWriter::ProgressReporter> progress_reporter;
@@ -688,6 +694,46 @@ QPDFWriter::setNewlineBeforeEndstream(bool val)
     m->cfg.newline_before_endstream(val);
 }
 
+void
+QPDFWriter::setPagesTreeFanout(size_t fanout)
+{
+    if (fanout == 1 || fanout == 2) {
+        throw std::invalid_argument(
+            "QPDFWriter::setPagesTreeFanout: fanout must be 0 or at least 3");
+    }
+    m->cfg.pages_tree_fanout(fanout);
+}
+
+void
+QPDFWriter::setDeduplicateStreams(bool val)
+{
+    m->cfg.deduplicate_streams(val);
+}
+
+size_t
+QPDFWriter::getDeduplicatedStreamCount() const
+{
+    return m->deduplicated_streams;
+}
+
+size_t
+QPDFWriter::getDeduplicatedStreamBytes() const
+{
+    return m->deduplicated_bytes;
+}
+
+void
+QPDFWriter::setDeduplicateObjects(bool val)
+{
+    m->cfg.deduplicate_objects(val);
+}
+
+size_t
+QPDFWriter::getDeduplicatedObjectCount() const
+{
+    return m->deduplicated_objects;
+}
+
 void
 QPDFWriter::setMinimumPDFVersion(std::string const& version, int extension_level)
 {
@@ -2253,6 +2299,184 @@ impl::Writer::generateObjectStreams()
     }
 }
 
+void
+impl::Writer::deduplicate()
+{
+    struct Digest
+    {
+        std::string sha256;
+        size_t length{0};
+    };
+    // Digests of raw stream data are kept across rounds so that each stream is read at most once.
+    // A stream whose data can't be read has an empty digest and is never treated as a duplicate.
+    std::map<QPDFObjGen, Digest> digests;
+
+    // Objects referenced from the trailer and objects whose identity matters are never merged with
+    // other objects. A page or annotation must not appear twice in the document, and form fields,
+    // outline items, and structure elements are nodes in trees of their own.
+    QPDFObjGen::set top_level;
+    for (auto const& item: qpdf.getTrailer().as_dictionary()) {
+        if (item.second.indirect()) {
+            top_level.add(item.second.getObjGen());
+        }
+    }
+    auto has_identity = [&top_level](QPDFObjectHandle const& oh) {
+        if (top_level.contains(oh.getObjGen())) {
+            return true;
+        }
+        Dictionary dict = oh;
+        if (!dict) {
+            return false;
+        }
+        if (dict.contains("/Rect") || dict.contains("/FT") || dict.contains("/T") ||
+            dict.contains("/Parent")) {
+            return true;
+        }
+        Name type = dict["/Type"];
+        return type &&
+            (type == "/Catalog" || type == "/Pages" || type == "/Page" || type == "/Annot" ||
+             type == "/StructTreeRoot" || type == "/StructElem" || type == "/Outlines");
+    };
+
+    auto digest = [&digests](QPDFObjectHandle const& oh) -> Digest const& {
+        auto [it, inserted] = digests.try_emplace(oh.getObjGen());
+        if (inserted) {
+            Pl_SHA2 sha256(256);
+            Pl_Count count("deduplicate count", &sha256);
+            if (Stream(oh).pipeStreamData(&count, nullptr, 0, qpdf_dl_none, true, false)) {
+                it->second.sha256 = sha256.getRawDigest();
+                it->second.length = QIntC::to_size(count.getCount());
+            }
+        }
+        return it->second;
+    };
+
+    while (true) {
+        // Find all indirect objects reachable from the trailer. An explicit stack is used since
+        // chains of indirect objects, such as outlines, can be very long.
+        std::vector<QPDFObjectHandle> reachable;
+        QPDFObjGen::set seen;
+        std::vector<QPDFObjectHandle> stack{qpdf.getTrailer()};
+        while (!stack.empty()) {
+            auto oh = std::move(stack.back());
+            stack.pop_back();
+            if (oh.indirect()) {
+                if (!seen.add(oh.getObjGen())) {
+                    continue;
+                }
+                reachable.emplace_back(oh);
+            }
+            if (Stream stream = oh) {
+                stack.emplace_back(stream.getDict());
+            } else if (Array array = oh) {
+                for (auto const& item: array) {
+                    stack.emplace_back(item);
+                }
+            } else if (Dictionary dict = oh) {
+                for (auto const& item: dict) {
+                    if (!item.second.null()) {
+                        stack.emplace_back(item.second);
+                    }
+                }
+            }
+        }
+
+        // Group streams by their dictionaries without /Length. Only streams that share a
+        // dictionary with another stream can be duplicates, so only those are hashed. Other
+        // objects are grouped by their complete values.
+        std::map<std::string, std::vector<QPDFObjectHandle>> by_dict;
+        std::map<std::string, std::vector<QPDFObjectHandle>> by_value;
+        for (auto const& oh: reachable) {
+            if (Stream stream = oh) {
+                if (cfg.deduplicate_streams() && !stream.isDataModified() &&
+                    !stream.isRootMetadata()) {
+                    Dictionary dict = oh.getDict().unsafeShallowCopy();
+                    dict.erase("/Length");
+                    by_dict[dict.unparse()].emplace_back(oh);
+                }
+            } else if (cfg.deduplicate_objects() && !has_identity(oh)) {
+                by_value[oh.unparseResolved()].emplace_back(oh);
+            }
+        }
+
+        auto by_objgen = [](auto const& a, auto const& b) {
+            return a.getObjGen() < b.getObjGen();
+        };
+        std::map<QPDFObjGen, QPDFObjectHandle> replacements;
+        for (auto& [key, group]: by_value) {
+            if (group.size() < 2) {
+                continue;
+            }
+            std::sort(group.begin(), group.end(), by_objgen);
+            for (auto it = std::next(group.begin()); it != group.end(); ++it) {
+                replacements.emplace(it->getObjGen(), group.front());
+                ++deduplicated_objects;
+            }
+        }
+        for (auto& [key, group]: by_dict) {
+            if (group.size() < 2) {
+                continue;
+            }
+            std::sort(group.begin(), group.end(), by_objgen);
+            std::map<std::string, QPDFObjectHandle> canonical;
+            for (auto const& oh: group) {
+                auto const& d = digest(oh);
+                if (d.sha256.empty()) {
+                    continue;
+                }
+                auto [it, inserted] = canonical.try_emplace(d.sha256, oh);
+                if (!inserted) {
+                    replacements.emplace(oh.getObjGen(), it->second);
+                    ++deduplicated_streams;
+                    deduplicated_bytes += d.length;
+                }
+            }
+        }
+        if (replacements.empty()) {
+            return;
+        }
+
+        // Replace references to duplicates in all reachable objects. This only follows direct
+        // objects since all indirect objects are visited.
+        auto replace = [&replacements](QPDFObjectHandle& oh) {
+            auto it = replacements.find(oh.getObjGen());
+            if (it != replacements.end()) {
+                oh = it->second;
+            }
+        };
+        reachable.emplace_back(qpdf.getTrailer());
+        for (auto const& top: reachable) {
+            stack.emplace_back(top.isStream() ? top.getDict() : top);
+            while (!stack.empty()) {
+                auto oh = std::move(stack.back());
+                stack.pop_back();
+                if (Array array = oh) {
+                    for (size_t i = 0; i < array.size(); ++i) {
+                        auto item = array.get(i);
+                        if (item.indirect()) {
+                            auto before = item.getObjGen();
+                            replace(item);
+                            if (item.getObjGen() != before) {
+                                array.set(i, item);
+                            }
+                        } else {
+                            stack.emplace_back(item);
+                        }
+                    }
+                } else if (Dictionary dict = oh) {
+                    for (auto& item: dict) {
+                        if (item.second.indirect()) {
+                            replace(item.second);
+                        } else if (!item.second.null()) {
+                            stack.emplace_back(item.second);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 Dictionary
 impl::Writer::trimmed_trailer()
 {
@@ -2321,6 +2545,17 @@ impl::Writer::doWriteSetup()
 
     // Do preliminary setup
 
+    if (cfg.pages_tree_fanout()) {
+        // This creates new objects, so it must be done before the object tables are initialized.
+        pages.balance(cfg.pages_tree_fanout());
+    }
+
+    if ((cfg.deduplicate_streams() || cfg.deduplicate_objects()) && !cfg.pclm()) {
+        // This changes which objects are referenced, so it must be done before object streams are
+        // set up.
+        deduplicate();
+    }
+
     if (cfg.linearize()) {
         cfg.qdf(false);
     }
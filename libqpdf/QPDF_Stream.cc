@@ -8,7 +8,9 @@
 #include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_Flate.hh>
+#include <qpdf/Pl_MD5.hh>
 #include <qpdf/Pl_QPDFTokenizer.hh>
+#include <qpdf/Pl_SHA2.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFExc.hh>
 #include <qpdf/QPDF_private.hh>
@@ -19,6 +21,7 @@
 #include <qpdf/SF_DCTDecode.hh>
 #include <qpdf/SF_FlateLzwDecode.hh>
 #include <qpdf/SF_RunLengthDecode.hh>
+#include <qpdf/WorkerPool.hh>
 
 #include <stdexcept>
 
@@ -428,7 +431,7 @@ Stream::writeStreamJSON(
         dict.removeKey("/DecodeParms");
     }
     if (json_data == qpdf_sj_file) {
-        jw.writeNext() << R"("datafile": ")" << JSON::Writer::encode_string(data_filename) << "\"";
+        jw.writeNext() << R"("datafile": ")" << JSON::Writer::encoded(data_filename) << "\"";
         p->writeString(buf_pl.getString());
     } else if (json_data == qpdf_sj_inline) {
         if (!no_data_key) {
@@ -790,6 +793,101 @@ Stream::warn(std::string const& message)
     qpdf()->warn(qpdf_e_damaged_pdf, "", offset(), message);
 }
 
+std::map<QPDFObjGen, QPDF::StreamDigests>
+QPDF::getStreamDigests(
+    std::vector<QPDFObjectHandle> const& objects,
+    qpdf_stream_decode_level_e decode_level,
+    size_t threads)
+{
+    // Reading stream data uses the input source and the object cache, so it is done on this
+    // thread. Decoding and hashing only use the data that was read and filters that are created
+    // for each stream, so they are done concurrently. Streams are processed in batches of one
+    // stream per thread to bound the amount of data held in memory.
+    struct Item
+    {
+        QPDFObjGen og;
+        qpdf_offset_t offset{0};
+        std::string data;
+        std::vector<std::shared_ptr<QPDFStreamFilter>> filters;
+        bool decode{false};
+        std::vector<std::string> warnings;
+        StreamDigests digests;
+    };
+
+    std::map<QPDFObjGen, StreamDigests> result;
+    WorkerPool pool(threads);
+    std::vector<Item> batch;
+
+    auto digest = [&batch](size_t i) {
+        auto& item = batch[i];
+        Pl_SHA2 sha256(256);
+        Pl_MD5 md5("md5", &sha256);
+        md5 << item.data;
+        md5.finish();
+        item.digests.raw_md5 = md5.getHexDigest();
+        item.digests.raw_sha256 = sha256.getHexDigest();
+        if (!item.decode) {
+            return;
+        }
+        Pl_SHA2 decoded_sha256(256);
+        Pl_MD5 decoded_md5("md5", &decoded_sha256);
+        Pipeline* p = &decoded_md5;
+        for (auto f = item.filters.rbegin(); f != item.filters.rend(); ++f) {
+            if (auto decode_pipeline = (*f)->getDecodePipeline(p)) {
+                p = decode_pipeline;
+            }
+            if (auto flate = dynamic_cast<Pl_Flate*>(p)) {
+                flate->setWarnCallback(
+                    [&item](char const* msg, int) { item.warnings.emplace_back(msg); });
+            }
+        }
+        try {
+            p->write(item.data.data(), item.data.size());
+            p->finish();
+        } catch (std::exception& e) {
+            item.warnings.emplace_back(
+                "error decoding stream data for object " + item.og.unparse(' ') + ": " + e.what());
+            return;
+        }
+        item.digests.decoded = true;
+        item.digests.decoded_md5 = decoded_md5.getHexDigest();
+        item.digests.decoded_sha256 = decoded_sha256.getHexDigest();
+    };
+
+    auto flush = [&]() {
+        pool.run(batch.size(), digest);
+        for (auto& item: batch) {
+            for (auto const& w: item.warnings) {
+                warn(qpdf_e_damaged_pdf, "", item.offset, w);
+            }
+            result.emplace(item.og, std::move(item.digests));
+        }
+        batch.clear();
+    };
+
+    for (auto const& obj: objects) {
+        Stream stream = obj;
+        if (!stream) {
+            continue;
+        }
+        std::string data;
+        pl::String buf(data);
+        if (!stream.pipeStreamData(&buf, nullptr, 0, qpdf_dl_none, false, false)) {
+            continue;
+        }
+        auto& item = batch.emplace_back();
+        item.og = stream.id_gen();
+        item.offset = stream.offset();
+        item.data = std::move(data);
+        item.decode = decode_level != qpdf_dl_none && stream.filterable(decode_level, item.filters);
+        if (batch.size() >= pool.size()) {
+            flush();
+        }
+    }
+    flush();
+    return result;
+}
+
 QPDFObjectHandle
 QPDFObjectHandle::getDict() const
 {
@@ -18,26 +18,26 @@ QPDF_String::writeJSON(int json_version, JSON::Writer& p)
 {
     if (json_version == 1) {
         if (util::is_utf16(val)) {
-            p << "\"" << JSON::Writer::encode_string(QUtil::utf16_to_utf8(val)) << "\"";
+            p << "\"" << JSON::Writer::encoded(QUtil::utf16_to_utf8(val)) << "\"";
             return;
         }
         if (util::is_explicit_utf8(val)) {
             // PDF 2.0 allows UTF-8 strings when explicitly prefixed with the three-byte
             // representation of U+FEFF.
-            p << "\"" << JSON::Writer::encode_string(val.substr(3)) << "\"";
+            p << "\"" << JSON::Writer::encoded(std::string_view(val).substr(3)) << "\"";
             return;
         }
-        p << "\"" << JSON::Writer::encode_string(QUtil::pdf_doc_to_utf8(val)) << "\"";
+        p << "\"" << JSON::Writer::encoded(QUtil::pdf_doc_to_utf8(val)) << "\"";
         return;
     }
     // See if we can unambiguously represent as Unicode.
     if (util::is_utf16(val)) {
-        p << "\"u:" << JSON::Writer::encode_string(QUtil::utf16_to_utf8(val)) << "\"";
+        p << "\"u:" << JSON::Writer::encoded(QUtil::utf16_to_utf8(val)) << "\"";
         return;
     }
     // See if we can unambiguously represent as Unicode.
     if (util::is_explicit_utf8(val)) {
-        p << "\"u:" << JSON::Writer::encode_string(val.substr(3)) << "\"";
+        p << "\"u:" << JSON::Writer::encoded(std::string_view(val).substr(3)) << "\"";
         return;
     }
     if (!useHexString()) {
@@ -45,7 +45,7 @@ QPDF_String::writeJSON(int json_version, JSON::Writer& p)
         std::string test;
         if (QUtil::utf8_to_pdf_doc(candidate, test, '?') && test == val) {
             // This is a PDF-doc string that can be losslessly encoded as Unicode.
-            p << "\"u:" << JSON::Writer::encode_string(candidate) << "\"";
+            p << "\"u:" << JSON::Writer::encoded(candidate) << "\"";
             return;
         }
     }
@@ -2,6 +2,7 @@
 
 #include <qpdf/FileInputSource.hh>
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/JSON_private.hh>
 #include <qpdf/JSON_writer.hh>
 #include <qpdf/Pl_Base64.hh>
 #include <qpdf/Pl_StdioFile.hh>
@@ -220,15 +221,27 @@ QPDF::test_json_validators()
 static std::function<void(Pipeline*)>
 provide_data(std::shared_ptr<InputSource> is, qpdf_offset_t start, qpdf_offset_t end)
 {
+    // The base64 data is read from the input and decoded in chunks so that neither the encoded nor
+    // the decoded data has to be held in memory as a whole.
     return [is, start, end](Pipeline* p) {
-        auto data = is->read(QIntC::to_size(end - start), start);
-        data = Pl_Base64::decode(data);
-        p->write(reinterpret_cast<const unsigned char*>(data.data()), data.size());
-        p->finish();
+        static size_t const chunk_size = 65536;
+        Pl_Base64 decode("base64-decode", p, Pl_Base64::a_decode);
+        std::string buf(chunk_size, '\0');
+        for (auto offset = start; offset < end;) {
+            buf.resize(is->readAt(
+                offset, buf.data(), std::min(chunk_size, QIntC::to_size(end - offset))));
+            if (buf.empty()) {
+                throw std::runtime_error(
+                    is->getName() + ": unexpected end of input reading stream data");
+            }
+            decode.write(reinterpret_cast<unsigned char const*>(buf.data()), buf.size());
+            offset += QIntC::to_offset(buf.size());
+        }
+        decode.finish();
     };
 }
 
-class QPDF::JSONReactor: public JSON::Reactor
+class QPDF::JSONReactor: public impl::JSONStreamingReactor
 {
   public:
     JSONReactor(QPDF& pdf, std::shared_ptr<InputSource> is, bool must_be_complete) :
@@ -247,6 +260,7 @@ class QPDF::JSONReactor: public JSON::Reactor
     void topLevelScalar() override;
     bool dictionaryItem(std::string const& key, JSON const& value) override;
     bool arrayItem(JSON const& value) override;
+    bool skipStringValue(std::string const& key) override;
 
     bool anyErrors() const;
 
@@ -664,6 +678,14 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
     return true;
 }
 
+bool
+QPDF::JSONReactor::skipStringValue(std::string const& key)
+{
+    // Stream data is read from the input when it is needed, so there is no point in keeping
+    // potentially huge base64 strings in memory while parsing.
+    return key == "data" && !stack.empty() && stack.back().state == st_stream;
+}
+
 bool
 QPDF::JSONReactor::arrayItem(JSON const& value)
 {
@@ -851,6 +873,28 @@ QPDF::writeJSON(
     if (version != 2) {
         throw std::runtime_error("QPDF::writeJSON: only version 2 is supported");
     }
+    // When only some objects are wanted, only those objects are read so that writing a few objects
+    // of a large file doesn't require reading the whole file. In that case, maxobjectid is the
+    // highest object number known without reading all objects.
+    bool all_objects = wanted_objects.empty();
+    std::vector<QPDFObjectHandle> objects;
+    size_t max_id = 0;
+    if (all_objects) {
+        max_id = getObjectCount();
+        objects = getAllObjects();
+    } else {
+        std::set<QPDFObjGen> wanted;
+        for (auto const& key: wanted_objects) {
+            int obj = 0;
+            int gen = 0;
+            if (is_obj_key(key, obj, gen)) {
+                wanted.emplace(obj, gen);
+            }
+        }
+        objects = m->objects.select(wanted);
+        max_id = QIntC::to_size(m->objects.known_max_id());
+    }
+
     JSON::Writer jw{p, 4};
     if (complete) {
         jw << "{";
@@ -867,36 +911,31 @@ QPDF::writeJSON(
           "      \"pdfversion\": \"" << getPDFVersion() << "\",\n"
           "      \"pushedinheritedpageresources\": " <<  (everPushedInheritedAttributesToPages() ? "true" : "false") << ",\n"
           "      \"calledgetallpages\": " <<  (everCalledGetAllPages() ? "true" : "false") << ",\n"
-          "      \"maxobjectid\": " <<  std::to_string(getObjectCount()) << "\n"
+          "      \"maxobjectid\": " <<  std::to_string(max_id) << "\n"
           "    },\n"
           "    {";
     /* clang-format on */
 
-    bool all_objects = wanted_objects.empty();
     bool first = true;
-    for (auto& obj: getAllObjects()) {
+    for (auto& obj: objects) {
         auto const og = obj.getObjGen();
         std::string key = "obj:" + og.unparse(' ') + " R";
-        if (all_objects || wanted_objects.contains(key)) {
-            if (first) {
-                jw << "\n      \"" << key;
-                first = false;
-            } else {
-                jw << "\n      },\n      \"" << key;
-            }
-            if (Stream stream = obj) {
-                jw << "\": {\n        \"stream\": ";
-                if (json_stream_data == qpdf_sj_file) {
-                    writeJSONStreamFile(
-                        version, jw, stream, og.getObj(), decode_level, file_prefix);
-                } else {
-                    stream.writeStreamJSON(
-                        version, jw, json_stream_data, decode_level, nullptr, "");
-                }
+        if (first) {
+            jw << "\n      \"" << key;
+            first = false;
+        } else {
+            jw << "\n      },\n      \"" << key;
+        }
+        if (Stream stream = obj) {
+            jw << "\": {\n        \"stream\": ";
+            if (json_stream_data == qpdf_sj_file) {
+                writeJSONStreamFile(version, jw, stream, og.getObj(), decode_level, file_prefix);
             } else {
-                jw << "\": {\n        \"value\": ";
-                obj.writeJSON(version, jw, true);
+                stream.writeStreamJSON(version, jw, json_stream_data, decode_level, nullptr, "");
             }
+        } else {
+            jw << "\": {\n        \"value\": ";
+            obj.writeJSON(version, jw, true);
         }
     }
     if (all_objects || wanted_objects.contains("trailer")) {
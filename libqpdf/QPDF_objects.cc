@@ -3,6 +3,7 @@
 #include <qpdf/QPDF_private.hh>
 
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/MD5.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/QPDFExc.hh>
@@ -13,12 +14,16 @@
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
+#include <qpdf/WorkerPool.hh>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstring>
 #include <limits>
 #include <map>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 using namespace qpdf;
@@ -120,6 +125,141 @@ namespace
                 "another process method) or after closeInputSource");
         }
     };
+
+    // During xref reconstruction, the file is scanned one line at a time. Each line yields at most
+    // one of an object header, an object header with an impossibly large object ID, or a trailer or
+    // startxref keyword.
+    struct ScannedLine
+    {
+        enum kind_e { none, object, large_id, trailer, startxref };
+
+        qpdf_offset_t start{0};
+        qpdf_offset_t next{0};
+        kind_e kind{none};
+        int obj{0};
+        int gen{0};
+        qpdf_offset_t offset{0};
+    };
+
+    struct ScanParameters
+    {
+        int max_id;
+        bool want_trailer;
+        bool want_startxref;
+    };
+
+    // Scan the line starting at the current position of input and leave input positioned at the
+    // start of the next line. Return false if the scan read up to `limit`, which is how a scan of
+    // part of the file detects that the outcome depends on data it doesn't have.
+    bool
+    scan_line(
+        Tokenizer& tokenizer,
+        InputSource& input,
+        qpdf_offset_t limit,
+        ScanParameters const& params,
+        ScannedLine& line)
+    {
+        // Don't allow very long tokens here during recovery. All the interesting tokens are
+        // covered.
+        static size_t const MAX_LEN = 10;
+        static std::string const context;
+        line = {};
+        line.start = input.tell();
+        auto t1 = tokenizer.readToken(input, context, true, MAX_LEN);
+        auto pos = input.tell();
+        if (pos >= limit) {
+            return false;
+        }
+        if (t1.isInteger()) {
+            auto t2 = tokenizer.readToken(input, context, true, MAX_LEN);
+            if (input.tell() >= limit) {
+                return false;
+            }
+            if (t2.isInteger()) {
+                auto t3 = tokenizer.readToken(input, context, true, MAX_LEN);
+                if (input.tell() >= limit) {
+                    return false;
+                }
+                if (t3.isWord("obj")) {
+                    int obj = QUtil::string_to_int(t1.getValue().c_str());
+                    line.kind = obj <= params.max_id ? ScannedLine::object : ScannedLine::large_id;
+                    line.obj = obj;
+                    line.gen = QUtil::string_to_int(t2.getValue().c_str());
+                    line.offset = pos - QIntC::to_offset(t1.getValue().length());
+                }
+            }
+            input.seek(pos, SEEK_SET);
+        } else if (params.want_trailer && t1.isWord("trailer")) {
+            line.kind = ScannedLine::trailer;
+            line.offset = pos;
+        } else if (params.want_startxref && t1.isWord("startxref")) {
+            line.kind = ScannedLine::startxref;
+            line.offset = pos;
+        }
+        input.findAndSkipNextEOL();
+        line.next = input.tell();
+        return line.next < limit;
+    }
+
+    // The result of scanning the lines that start in [start, end) of a copy of part of the file.
+    // The scan starts at the first line start at or after `start`, which need not be a line visited
+    // by a scan of the whole file, and the results are only used from the point at which the two
+    // scans meet.
+    struct ScannedChunk
+    {
+        qpdf_offset_t start{0};
+        qpdf_offset_t end{0};
+        // Starts of the lines that were scanned, in increasing order
+        std::vector<qpdf_offset_t> lines;
+        // Lines in which something was found
+        std::vector<ScannedLine> found;
+        // The start of the first line at or after end or, if the scan is incomplete, of the first
+        // line that could not be scanned with the available data
+        qpdf_offset_t exit{0};
+        bool complete{false};
+    };
+
+    // Scan a chunk. `data` contains the file from `start` - 1, so that a line beginning right at
+    // `start` is recognized, to `start` - 1 + data.size().
+    void
+    scan_chunk(
+        std::string_view data, qpdf_offset_t eof, ScanParameters params, ScannedChunk& chunk)
+    {
+        try {
+            auto data_start = std::max(chunk.start - 1, qpdf_offset_t(0));
+            auto data_end = data_start + QIntC::to_offset(data.size());
+            auto limit = data_end < eof ? data_end : std::numeric_limits<qpdf_offset_t>::max();
+            is::OffsetBuffer input("xref reconstruction", data, data_start);
+            Tokenizer tokenizer;
+            if (chunk.start > 0) {
+                input.findAndSkipNextEOL();
+            }
+            auto pos = input.tell();
+            if (pos >= limit) {
+                chunk.exit = pos;
+                return;
+            }
+            ScannedLine line;
+            while (pos < chunk.end) {
+                if (!scan_line(tokenizer, input, limit, params, line)) {
+                    chunk.exit = pos;
+                    return;
+                }
+                chunk.lines.emplace_back(pos);
+                if (line.kind != ScannedLine::none) {
+                    chunk.found.emplace_back(line);
+                }
+                pos = line.next;
+            }
+            chunk.exit = pos;
+            chunk.complete = true;
+        } catch (std::exception&) {
+            // Leave the whole chunk to the serial scan, which reports the error.
+            chunk.lines.clear();
+            chunk.found.clear();
+            chunk.complete = false;
+        }
+    }
 } // namespace
 
 class QPDF::ResolveRecorder final
@@ -239,40 +379,42 @@ Objects::parse(char const* password)
     if (m->xref_table_max_id > m->xref_table_max_offset / 3) {
         m->xref_table_max_id = static_cast<int>(m->xref_table_max_offset / 3);
     }
-    qpdf_offset_t start_offset = (end_offset > 1054 ? end_offset - 1054 : 0);
-    PatternFinder sf(*this, &Objects::findStartxref);
-    qpdf_offset_t xref_offset = 0;
-    if (m->file->findLast("startxref", start_offset, 0, sf)) {
-        xref_offset = QUtil::string_to_ll(readToken(*m->file).getValue().c_str());
-    }
-
-    try {
-        if (xref_offset == 0) {
-            throw damagedPDF("", -1, "can't find startxref");
+    if (!read_xref_index()) {
+        qpdf_offset_t start_offset = (end_offset > 1054 ? end_offset - 1054 : 0);
+        PatternFinder sf(*this, &Objects::findStartxref);
+        qpdf_offset_t xref_offset = 0;
+        if (m->file->findLast("startxref", start_offset, 0, sf)) {
+            xref_offset = QUtil::string_to_ll(readToken(*m->file).getValue().c_str());
         }
+
         try {
-            read_xref(xref_offset);
-        } catch (QPDFExc&) {
-            throw;
-        } catch (std::exception& e) {
-            throw damagedPDF("", -1, std::string("error reading xref: ") + e.what());
-        }
-    } catch (QPDFExc& e) {
-        if (global::Options::inspection_mode()) {
+            if (xref_offset == 0) {
+                throw damagedPDF("", -1, "can't find startxref");
+            }
             try {
-                reconstruct_xref(e, xref_offset > 0);
-            } catch (std::exception& er) {
-                warn(damagedPDF("", -1, "error reconstructing xref: "s + er.what()));
+                read_xref(xref_offset);
+            } catch (QPDFExc&) {
+                throw;
+            } catch (std::exception& e) {
+                throw damagedPDF("", -1, std::string("error reading xref: ") + e.what());
             }
-            if (!m->trailer) {
-                m->trailer = Dictionary::empty();
+        } catch (QPDFExc& e) {
+            if (global::Options::inspection_mode()) {
+                try {
+                    reconstruct_xref(e, xref_offset > 0);
+                } catch (std::exception& er) {
+                    warn(damagedPDF("", -1, "error reconstructing xref: "s + er.what()));
+                }
+                if (!m->trailer) {
+                    m->trailer = Dictionary::empty();
+                }
+                return;
             }
-            return;
-        }
-        if (cf.surpress_recovery()) {
-            throw;
+            if (cf.surpress_recovery()) {
+                throw;
+            }
+            reconstruct_xref(e, xref_offset > 0);
         }
-        reconstruct_xref(e, xref_offset > 0);
     }
 
     m->encp->initialize(qpdf);
@@ -289,6 +431,140 @@ Objects::parse(char const* password)
     }
 }
 
+// The cross-reference index file written by writeXRefIndexFile is a text file consisting of a
+// header line, a line identifying the input it was written for, a line with the state of the xref
+// table that is not otherwise recorded (whether it was reconstructed and the linearization related
+// offsets) followed by the number of entries, the unparsed trailer dictionary, one line per xref
+// table entry with the object number, generation, type, and the two fields of the entry, and an
+// end marker. The entry count and end marker allow truncated files to be detected.
+
+namespace
+{
+    std::string const xref_index_header = "%qpdf-xref-index 1";
+    std::string const xref_index_end = "%qpdf-xref-index end";
+} // namespace
+
+std::string
+Objects::xref_index_key()
+{
+    // Identify the input by its size and a digest of the region that contains the trailer.
+    qpdf_offset_t end_offset = m->xref_table_max_offset;
+    qpdf_offset_t start_offset = (end_offset > 1054 ? end_offset - 1054 : 0);
+    std::string buf(static_cast<size_t>(end_offset - start_offset), '\0');
+    buf.resize(m->file->readAt(start_offset, buf.data(), buf.size()));
+    MD5 md5;
+    md5.encodeDataIncrementally(buf);
+    return std::to_string(end_offset) + " " + md5.unparse();
+}
+
+bool
+Objects::read_xref_index()
+{
+    // Load the xref table and trailer from the index file if there is one and it matches the input.
+    // Any problem with the index file causes it to be ignored. An index for a reconstructed xref
+    // table is not used if recovery is suppressed, since the file would otherwise fail to open.
+    auto const& filename = cf.xref_index_file();
+    if (filename.empty()) {
+        return false;
+    }
+    std::map<QPDFObjGen, QPDFXRefEntry> xref_table;
+    std::string trailer;
+    bool reconstructed = false;
+    qpdf_offset_t first_xref_item_offset = 0;
+    bool uncompressed_after_compressed = false;
+    try {
+        auto lines = QUtil::read_lines_from_file(filename.c_str());
+        if (lines.size() < 5 || lines.back() != xref_index_end) {
+            return false;
+        }
+        lines.pop_back();
+        auto line = lines.begin();
+        if (*line++ != xref_index_header || *line++ != xref_index_key()) {
+            return false;
+        }
+        std::istringstream state(*line++);
+        size_t entries = 0;
+        state >> reconstructed >> first_xref_item_offset >> uncompressed_after_compressed >>
+            entries;
+        if (state.fail() || entries != lines.size() - 4) {
+            return false;
+        }
+        if (reconstructed && (cf.surpress_recovery() || global::Options::inspection_mode())) {
+            return false;
+        }
+        trailer = *line++;
+        for (; line != lines.end(); ++line) {
+            std::istringstream in(*line);
+            int obj = 0;
+            int gen = 0;
+            int type = 0;
+            qpdf_offset_t f1 = 0;
+            int f2 = 0;
+            in >> obj >> gen >> type >> f1 >> f2;
+            if (in.fail() || obj < 1 || obj > m->xref_table_max_id || gen < 0 || f1 < 0 ||
+                f1 >= m->xref_table_max_offset || !(type == 1 || type == 2)) {
+                return false;
+            }
+            xref_table.insert_or_assign(QPDFObjGen(obj, gen), QPDFXRefEntry(type, f1, f2));
+        }
+    } catch (std::exception&) {
+        return false;
+    }
+
+    m->xref_table = std::move(xref_table);
+    try {
+        // The trailer can only be parsed once the xref table is known.
+        auto oh = QPDFObjectHandle::parse(&qpdf, trailer, "trailer from xref index");
+        if (!oh.isDictionary()) {
+            throw std::runtime_error("trailer is not a dictionary");
+        }
+        m->trailer = oh;
+    } catch (std::exception&) {
+        m->xref_table.clear();
+        m->obj_cache.clear();
+        return false;
+    }
+    m->reconstructed_xref = reconstructed;
+    first_xref_item_offset_ = first_xref_item_offset;
+    uncompressed_after_compressed_ = uncompressed_after_compressed;
+    used_xref_index_ = true;
+    if (reconstructed) {
+        warn(damagedPDF("", -1, "file is damaged; using reconstructed xref index"));
+    }
+    return true;
+}
+
+void
+Objects::write_xref_index(std::string const& filename)
+{
+    util::assertion(m->parsed, "QPDF::writeXRefIndexFile called before processing a file");
+    std::string out = xref_index_header + "\n" + xref_index_key() + "\n" +
+        (m->reconstructed_xref ? "1 " : "0 ") + std::to_string(first_xref_item_offset_) +
+        (uncompressed_after_compressed_ ? " 1 " : " 0 ") + std::to_string(m->xref_table.size()) +
+        "\n" + m->trailer.unparse() + "\n";
+    for (auto const& [og, entry]: m->xref_table) {
+        out += og.unparse(' ') + " " + std::to_string(entry.getType()) + " ";
+        if (entry.getType() == 1) {
+            out += std::to_string(entry.getOffset()) + " 0\n";
+        } else {
+            out += std::to_string(entry.getObjStreamNumber()) + " " +
+                std::to_string(entry.getObjStreamIndex()) + "\n";
+        }
+    }
+    out += xref_index_end + "\n";
+    // Write to a temporary file and rename it so that a reader never sees a partially written
+    // index.
+    auto tmp = filename + ".tmp";
+    FILE* f = QUtil::safe_fopen(tmp.c_str(), "wb");
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        QUtil::remove_file(tmp.c_str());
+        throw std::runtime_error("error writing cross-reference index file " + filename);
+    }
+    QUtil::rename_file(tmp.c_str(), filename.c_str());
+}
+
 void
 Objects::inParse(bool v)
 {
@@ -352,33 +628,99 @@ Objects::reconstruct_xref(QPDFExc& e, bool found_startxref)
 
     m->file->seek(0, SEEK_END);
     qpdf_offset_t eof = m->file->tell();
-    m->file->seek(0, SEEK_SET);
-    // Don't allow very long tokens here during recovery. All the interesting tokens are covered.
-    static size_t const MAX_LEN = 10;
-    while (m->file->tell() < eof) {
-        QPDFTokenizer::Token t1 = m->objects.readToken(*m->file, MAX_LEN);
-        qpdf_offset_t token_start = m->file->tell() - toO(t1.getValue().length());
-        if (t1.isInteger()) {
-            auto pos = m->file->tell();
-            auto t2 = m->objects.readToken(*m->file, MAX_LEN);
-            if (t2.isInteger() && m->objects.readToken(*m->file, MAX_LEN).isWord("obj")) {
-                int obj = QUtil::string_to_int(t1.getValue().c_str());
-                int gen = QUtil::string_to_int(t2.getValue().c_str());
-                if (obj <= m->xref_table_max_id) {
-                    found_objects.emplace_back(obj, gen, token_start);
-                } else {
-                    warn(damagedPDF(
-                        "", -1, "ignoring object with impossibly large id " + std::to_string(obj)));
+    ScanParameters const params{m->xref_table_max_id, !m->trailer, !found_startxref};
+    auto record = [&](ScannedLine const& line) {
+        switch (line.kind) {
+        case ScannedLine::object:
+            found_objects.emplace_back(line.obj, line.gen, line.offset);
+            break;
+        case ScannedLine::large_id:
+            warn(damagedPDF(
+                "", -1, "ignoring object with impossibly large id " + std::to_string(line.obj)));
+            break;
+        case ScannedLine::trailer:
+            trailers.emplace_back(line.offset);
+            break;
+        case ScannedLine::startxref:
+            startxrefs.emplace_back(line.offset);
+            break;
+        case ScannedLine::none:
+            break;
+        }
+        check_warnings();
+    };
+
+    // Scan the file serially from pos until reaching `until` or the start of one of `lines`.
+    qpdf_offset_t pos = 0;
+    auto scan_file = [&](qpdf_offset_t until, std::vector<qpdf_offset_t> const& lines) {
+        static auto const no_limit = std::numeric_limits<qpdf_offset_t>::max();
+        m->file->seek(pos, SEEK_SET);
+        ScannedLine line;
+        while (pos < until && !std::binary_search(lines.begin(), lines.end(), pos)) {
+            scan_line(m->tokenizer, *m->file, no_limit, params, line);
+            record(line);
+            pos = line.next;
+        }
+    };
+
+    // Files that are large enough are split into chunks that are scanned concurrently, a batch of
+    // one chunk per thread at a time. The results are merged in file order. Where a chunk's scan
+    // doesn't meet the serial sequence of lines, including at its start, the file itself is scanned
+    // until it does, so the outcome is exactly that of a serial scan.
+    static qpdf_offset_t const parallel_threshold = 16 << 20;
+    static qpdf_offset_t const max_chunk_size = 4 << 20;
+    static qpdf_offset_t const max_lookahead = 64 << 10;
+    size_t threads = m->cf.threads();
+    if (threads == 0) {
+        threads = eof >= parallel_threshold ? std::thread::hardware_concurrency() : 1;
+    }
+    if (threads < 2 || eof == 0) {
+        scan_file(eof, {});
+    } else {
+        auto chunk_size = std::min(max_chunk_size, (eof + toO(threads) - 1) / toO(threads));
+        auto lookahead = std::min(max_lookahead, chunk_size);
+        std::vector<std::string> buffers(threads);
+        std::vector<ScannedChunk> chunks(threads);
+        WorkerPool pool(threads);
+        for (qpdf_offset_t batch = 0; batch < eof; batch += chunk_size * toO(threads)) {
+            size_t n = 0;
+            for (; n < threads && batch + toO(n) * chunk_size < eof; ++n) {
+                auto& chunk = chunks[n];
+                chunk = {};
+                chunk.start = batch + toO(n) * chunk_size;
+                chunk.end = std::min(chunk.start + chunk_size, eof);
+            }
+            // Each chunk is read with a positional read by the thread that scans it, so reading
+            // overlaps with scanning.
+            pool.run(n, [&](size_t i) {
+                auto& chunk = chunks[i];
+                auto data_start = std::max(chunk.start - 1, qpdf_offset_t(0));
+                auto& buffer = buffers[i];
+                buffer.resize(toS(std::min(chunk.end + lookahead, eof) - data_start));
+                buffer.resize(m->file->readAt(data_start, buffer.data(), buffer.size()));
+                scan_chunk(buffer, eof, params, chunk);
+            });
+            for (size_t i = 0; i < n; ++i) {
+                auto const& chunk = chunks[i];
+                while (pos < chunk.end) {
+                    if (std::binary_search(chunk.lines.begin(), chunk.lines.end(), pos)) {
+                        auto found = std::find_if(
+                            chunk.found.begin(), chunk.found.end(), [&](auto const& line) {
+                                return line.start >= pos;
+                            });
+                        for (; found != chunk.found.end(); ++found) {
+                            record(*found);
+                        }
+                        pos = chunk.exit;
+                        if (!chunk.complete) {
+                            scan_file(chunk.end, {});
+                        }
+                    } else {
+                        scan_file(chunk.end, chunk.lines);
+                    }
                 }
             }
-            m->file->seek(pos, SEEK_SET);
-        } else if (!m->trailer && t1.isWord("trailer")) {
-            trailers.emplace_back(m->file->tell());
-        } else if (!found_startxref && t1.isWord("startxref")) {
-            startxrefs.emplace_back(m->file->tell());
         }
-        check_warnings();
-        m->file->findAndSkipNextEOL();
     }
 
     if (!found_startxref && !startxrefs.empty() && !found_objects.empty() &&
@@ -1217,6 +1559,12 @@ QPDF::showXRefTable()
     }
 }
 
+void
+QPDF::writeXRefIndexFile(std::string const& filename)
+{
+    m->objects.write_xref_index(filename);
+}
+
 // Resolve all objects in the xref table. If this triggers a xref table reconstruction abort and
 // return false. Otherwise return true.
 bool
@@ -1262,6 +1610,12 @@ QPDF::getObjectCount()
     return QIntC::to_size(og.getObj());
 }
 
+size_t
+QPDF::getResolvedObjectCount() const
+{
+    return m->objects.resolved_count();
+}
+
 std::vector<QPDFObjectHandle>
 QPDF::getAllObjects()
 {
@@ -1274,6 +1628,45 @@ QPDF::getAllObjects()
     return result;
 }
 
+void
+QPDF::makeReadOnlySnapshot()
+{
+    // After fixDanglingReferences, every object in the xref table has been resolved. Also resolve
+    // any other object that has been referenced, and prime the caches that readers would otherwise
+    // fill in on first use.
+    fixDanglingReferences();
+    for (auto& [og, entry]: m->obj_cache) {
+        if (entry.object->getTypeCode() == ::ot_unresolved) {
+            m->objects.resolve(og);
+        }
+    }
+    (void)getRoot();
+    (void)getAllPages();
+    m->read_only_snapshot = true;
+}
+
+std::vector<QPDFObjectHandle>
+Objects::select(std::set<QPDFObjGen> const& wanted)
+{
+    std::vector<QPDFObjectHandle> result;
+    for (auto og: wanted) {
+        if (m->obj_cache.contains(og) || (!m->fixed_dangling_refs && m->xref_table.contains(og))) {
+            result.emplace_back(qpdf.getObject(og));
+        }
+    }
+    return result;
+}
+
+int
+Objects::known_max_id() const
+{
+    int result = m->obj_cache.empty() ? 0 : m->obj_cache.rbegin()->first.getObj();
+    if (!m->xref_table.empty()) {
+        result = std::max(result, m->xref_table.rbegin()->first.getObj());
+    }
+    return result;
+}
+
 void
 Objects::setLastObjectDescription(std::string const& description, QPDFObjGen og)
 {
@@ -1591,6 +1984,7 @@ Objects::readObjectAtOffset(
             }
         }
         m->objects.updateCache(og, oh.obj_sp(), end_before_space, m->file->tell());
+        ++resolved_count_;
     }
 }
 
@@ -1843,6 +2237,7 @@ Objects::resolveObjectsInStream(int obj_stream_number)
             is::OffsetBuffer in("", {b_start + obj_offset, obj_size}, obj_offset);
             if (auto oh = Parser::parse(in, obj_stream_number, obj_id, m->tokenizer, qpdf)) {
                 updateCache(og, oh.obj_sp(), end_before_space, end_after_space);
+                ++resolved_count_;
             }
         } else {
             QTC::TC("qpdf", "QPDF not caching overridden objstm object");
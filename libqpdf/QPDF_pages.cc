@@ -40,6 +40,27 @@
 // insertPage, and removePage, along with methods they call, are concerned with it.  Everything else
 // goes through one of those methods.
 
+// If a pages tree fanout has been configured with QPDF::setPagesTreeFanout, flattenPagesTree builds
+// a balanced tree instead of a flat one, and the tree_* methods keep it balanced in the manner of a
+// B-tree: all pages are at the same depth, /Pages nodes other than the root have between
+// ceil(fanout / 2) and fanout kids, nodes that overflow are split, and nodes that underflow borrow
+// a kid from or are joined with an adjacent sibling. The fanout is at least 3, so every node other
+// than the root has at least two kids, which keeps the depth logarithmic in the number of pages.
+// The root /Pages object is never replaced as it may be referenced from elsewhere and may carry
+// keys of its own, so the tree grows and shrinks in height directly below the root. /Count is kept
+// correct for every node, and every kid's /Parent points to the node that contains it, which
+// allows the position of a page to be computed by walking from the page to the root. In this mode,
+// pageobj_to_pages_pos is not used and tree_pages_ records which objects are pages. all_pages is
+// still updated in place, which is a single memmove of the handles following the insertion or
+// removal point.
+
+// In lazy mode, which supports minimal touch page extraction, locate finds individual pages by
+// descending the pages tree from the root, using /Count to pick the kid to descend into, so that
+// only the /Pages nodes on the path to a page are read. Inheritable attributes are copied to the
+// located page as pushInheritedAttributesToPage would do. locate gives up as soon as it finds
+// anything getAllPages would have to repair, and the /Count of each visited node must match its
+// kids, but the /Count entries of subtrees that are not visited have to be trusted.
+
 using Pages = QPDF::Doc::Pages;
 
 std::vector<QPDFObjectHandle> const&
@@ -265,16 +286,104 @@ Pages::update_cache()
     // recalculation of pageobj_to_pages_pos until needed.
     all_pages.clear();
     pageobj_to_pages_pos.clear();
+    tree_fanout_ = 0;
+    tree_pages_.clear();
     pushed_inherited_attributes_to_pages = false;
     cache();
 }
 
+size_t
+Pages::declared_size()
+{
+    Integer count = qpdf.getRoot()["/Pages"]["/Count"];
+    return count && count.value() > 0 ? count.value<size_t>() : 0;
+}
+
+QPDFObjectHandle
+Pages::locate(size_t pos)
+{
+    if (!lazy_ || !all_pages.empty()) {
+        auto const& pages = all();
+        return pos < pages.size() ? pages.at(pos) : QPDFObjectHandle();
+    }
+
+    static uint32_t constexpr max_level = 100;
+    std::map<std::string, QPDFObjectHandle> inherited;
+    QPDFObjGen::set visited;
+    QPDFObjectHandle node = qpdf.getRoot()["/Pages"];
+    for (uint32_t level = 0; level < max_level; ++level) {
+        if (!(node.indirect() && node.isDictionaryOfType("/Pages") && visited.add(node))) {
+            return {};
+        }
+        for (auto const& key: {"/MediaBox", "/CropBox", "/Resources", "/Rotate"}) {
+            if (auto oh = node[key]; !oh.null()) {
+                if (!(oh.indirect() || oh.isScalar())) {
+                    // As in pushInheritedAttributesToPageInternal, avoid sharing direct objects.
+                    oh = qpdf.makeIndirectObject(oh);
+                    node.replaceKey(key, oh);
+                }
+                inherited[key] = oh;
+            }
+        }
+        Array kids = node["/Kids"];
+        Integer count = node["/Count"];
+        if (!(kids && count)) {
+            return {};
+        }
+        size_t total = 0;
+        QPDFObjectHandle next;
+        for (auto const& kid: kids) {
+            if (!(kid.indirect() && kid.isDictionary())) {
+                return {};
+            }
+            size_t kid_count = 1;
+            if (kid.contains("/Kids")) {
+                Integer n = kid["/Count"];
+                if (!n || n.value() < 0) {
+                    return {};
+                }
+                kid_count = n.value<size_t>();
+            }
+            if (!next && pos < total + kid_count) {
+                next = kid;
+                pos -= total;
+            }
+            total += kid_count;
+        }
+        if (!next || std::cmp_not_equal(count.value(), total)) {
+            return {};
+        }
+        if (next.contains("/Kids")) {
+            node = next;
+            continue;
+        }
+
+        auto attribute = [&](std::string const& key) {
+            return next.contains(key) ? next[key]
+                                      : (inherited.contains(key) ? inherited[key] : QPDFObjectHandle());
+        };
+        auto annots = next["/Annots"];
+        if (!(next.isDictionaryOfType("/Page") && attribute("/MediaBox").isRectangle() &&
+              attribute("/Resources").isDictionary() && (annots.null() || annots.isArray()))) {
+            return {};
+        }
+        for (auto const& [key, value]: inherited) {
+            if (!next.contains(key)) {
+                next.replaceKey(key, value);
+            }
+        }
+        return next;
+    }
+    return {};
+}
+
 void
-Pages::flattenPagesTree()
+Pages::flattenPagesTree(size_t fanout)
 {
-    // If not already done, flatten the /Pages structure and initialize pageobj_to_pages_pos.
+    // If not already done, flatten the /Pages structure and initialize pageobj_to_pages_pos, or, if
+    // fanout is not 0, build a balanced /Pages structure and initialize tree_pages_.
 
-    if (!pageobj_to_pages_pos.empty()) {
+    if (!pageobj_to_pages_pos.empty() || tree_fanout_) {
         return;
     }
 
@@ -285,15 +394,31 @@ Pages::flattenPagesTree()
     QPDFObjectHandle pages = qpdf.getRoot().getKey("/Pages");
 
     size_t const len = all_pages.size();
-    for (size_t pos = 0; pos < len; ++pos) {
-        // Populate pageobj_to_pages_pos and fix parent pointer. There should be no duplicates at
-        // this point because pushInheritedAttributesToPage calls getAllPages which resolves
-        // duplicates.
-        insertPageobjToPage(all_pages.at(pos), toI(pos), true);
-        all_pages.at(pos).replaceKey("/Parent", pages);
-    }
+    if (fanout) {
+        tree_fanout_ = fanout;
+        for (auto const& page: all_pages) {
+            // There should be no duplicates at this point for the same reason as below.
+            if (!tree_pages_.add(page)) {
+                throw QPDFExc(
+                    qpdf_e_pages,
+                    m->file->getName(),
+                    "page object: object " + page.id_gen().unparse(' '),
+                    0,
+                    "duplicate page reference found; this would cause loss of data");
+            }
+        }
+        build_tree();
+    } else {
+        for (size_t pos = 0; pos < len; ++pos) {
+            // Populate pageobj_to_pages_pos and fix parent pointer. There should be no duplicates
+            // at this point because pushInheritedAttributesToPage calls getAllPages which resolves
+            // duplicates.
+            insertPageobjToPage(all_pages.at(pos), toI(pos), true);
+            all_pages.at(pos).replaceKey("/Parent", pages);
+        }
 
-    pages.replaceKey("/Kids", Array(all_pages));
+        pages.replaceKey("/Kids", Array(all_pages));
+    }
     // /Count has not changed
     if (pages.getKey("/Count").getUIntValue() != len) {
         if (invalid_page_found && pages.getKey("/Count").getUIntValue() > len) {
@@ -304,6 +429,253 @@ Pages::flattenPagesTree()
     }
 }
 
+void
+Pages::balance(size_t fanout)
+{
+    util::assertion(fanout == 0 || fanout >= 3, "Pages::balance called with fanout 1 or 2");
+    if (tree_fanout_ == fanout && (fanout || !pageobj_to_pages_pos.empty())) {
+        return;
+    }
+    pageobj_to_pages_pos.clear();
+    tree_fanout_ = 0;
+    tree_pages_.clear();
+    flattenPagesTree(fanout);
+}
+
+void
+Pages::build_tree()
+{
+    auto const fanout = tree_fanout_;
+    auto root = qpdf.getRoot()["/Pages"];
+
+    // Build the tree bottom up. Each level is divided into as few nodes as possible with the sizes
+    // of the nodes differing by at most one, which keeps every node at least half full.
+    std::vector<QPDFObjectHandle> level = all_pages;
+    while (level.size() > fanout) {
+        size_t const n_nodes = (level.size() + fanout - 1) / fanout;
+        std::vector<QPDFObjectHandle> nodes;
+        nodes.reserve(n_nodes);
+        auto kid = level.cbegin();
+        for (size_t i = 0; i < n_nodes; ++i) {
+            auto n_kids = level.size() / n_nodes + (i < level.size() % n_nodes ? 1 : 0);
+            nodes.emplace_back(tree_node({kid, kid + toI(n_kids)}, root));
+            kid += toI(n_kids);
+        }
+        level = std::move(nodes);
+    }
+    for (auto& kid: level) {
+        kid.replaceKey("/Parent", root);
+    }
+    root.replaceKey("/Kids", Array(std::move(level)));
+}
+
+namespace
+{
+    // Return the number of pages below a kid of a /Pages node.
+    size_t
+    page_count(QPDFObjectHandle const& kid)
+    {
+        return kid.contains("/Kids") ? Integer(kid["/Count"]).value<size_t>() : 1;
+    }
+} // namespace
+
+QPDFObjectHandle
+Pages::tree_node(std::vector<QPDFObjectHandle> const& kids, QPDFObjectHandle const& parent)
+{
+    size_t count = 0;
+    auto node = qpdf.makeIndirectObject(Dictionary::empty());
+    for (auto kid: kids) {
+        count += page_count(kid);
+        kid.replaceKey("/Parent", node);
+    }
+    node.replaceKey("/Type", Name("/Pages"));
+    node.replaceKey("/Parent", parent);
+    node.replaceKey("/Kids", Array(kids));
+    node.replaceKey("/Count", Integer(count));
+    return node;
+}
+
+void
+Pages::tree_count(QPDFObjectHandle node, int delta)
+{
+    // Adjust /Count of node and all its ancestors.
+    auto root = qpdf.getRoot()["/Pages"];
+    while (true) {
+        node.replaceKey("/Count", Integer(Integer(node["/Count"]).value() + delta));
+        if (node.isSameObjectAs(root)) {
+            return;
+        }
+        node = node["/Parent"];
+    }
+}
+
+void
+Pages::tree_insert(QPDFObjectHandle newpage, size_t pos)
+{
+    // Descend to the lowest-level node that will contain the new page. Kids of a /Pages node are
+    // either all /Pages nodes or all pages.
+    auto node = qpdf.getRoot()["/Pages"];
+    while (true) {
+        Array kids = node["/Kids"];
+        if (kids.size() == 0 || !kids[0].contains("/Kids")) {
+            break;
+        }
+        for (auto const& kid: kids) {
+            node = kid;
+            auto count = page_count(kid);
+            if (pos <= count) {
+                break;
+            }
+            pos -= count;
+        }
+    }
+    Array(node["/Kids"]).insert(pos, newpage);
+    newpage.replaceKey("/Parent", node);
+    tree_count(node, 1);
+    tree_split(node);
+}
+
+void
+Pages::tree_split(QPDFObjectHandle node)
+{
+    Array kids = node["/Kids"];
+    if (kids.size() <= tree_fanout_) {
+        return;
+    }
+    auto items = kids.getAsVector();
+    auto middle = items.cbegin() + toI(items.size() / 2);
+    auto root = qpdf.getRoot()["/Pages"];
+    if (node.isSameObjectAs(root)) {
+        // Move the kids of the root into two new nodes. This is the only place where the tree
+        // grows in height.
+        root.replaceKey(
+            "/Kids",
+            Array({tree_node({items.cbegin(), middle}, root), tree_node({middle, items.cend()}, root)}));
+        return;
+    }
+    auto parent = node["/Parent"];
+    auto sibling = tree_node({middle, items.cend()}, parent);
+    kids.setFromVector({items.cbegin(), middle});
+    node.replaceKey("/Count", Integer(Integer(node["/Count"]).value<size_t>() - page_count(sibling)));
+    Array(parent["/Kids"]).insert(tree_index(parent, node) + 1, sibling);
+    tree_split(parent);
+}
+
+void
+Pages::tree_erase(QPDFObjectHandle const& page)
+{
+    auto node = page["/Parent"];
+    Array(node["/Kids"]).erase(tree_index(node, page));
+    tree_count(node, -1);
+    tree_join(node);
+}
+
+void
+Pages::tree_join(QPDFObjectHandle node)
+{
+    Array kids = node["/Kids"];
+    auto root = qpdf.getRoot()["/Pages"];
+    if (node.isSameObjectAs(root)) {
+        // Replace a root with a single /Pages kid by that kid's kids. This is the only place where
+        // the tree shrinks in height.
+        while (kids.size() == 1 && kids[0].contains("/Kids")) {
+            auto items = Array(kids[0]["/Kids"]).getAsVector();
+            for (auto& kid: items) {
+                kid.replaceKey("/Parent", root);
+            }
+            kids.setFromVector(items);
+        }
+        return;
+    }
+    if (kids.size() >= (tree_fanout_ + 1) / 2) {
+        return;
+    }
+    auto parent = node["/Parent"];
+    Array parent_kids = parent["/Kids"];
+    auto i = tree_index(parent, node);
+    if (parent_kids.size() == 1) {
+        // Only possible if parent is the root.
+        if (kids.size() == 0) {
+            parent_kids.erase(i);
+        }
+        tree_join(parent);
+        return;
+    }
+    // Join node with an adjacent sibling if their kids fit into a single node. Otherwise, move the
+    // sibling's closest kid to node.
+    size_t left = i > 0 ? i - 1 : i;
+    QPDFObjectHandle left_node = parent_kids[left];
+    QPDFObjectHandle right_node = parent_kids[left + 1];
+    Array left_kids = left_node["/Kids"];
+    Array right_kids = right_node["/Kids"];
+    if (left_kids.size() + right_kids.size() <= tree_fanout_) {
+        for (auto& kid: right_kids) {
+            kid.replaceKey("/Parent", left_node);
+            left_kids.push_back(kid);
+        }
+        left_node.replaceKey(
+            "/Count",
+            Integer(
+                Integer(left_node["/Count"]).value<size_t>() +
+                Integer(right_node["/Count"]).value<size_t>()));
+        parent_kids.erase(left + 1);
+        tree_join(parent);
+        return;
+    }
+    QPDFObjectHandle kid;
+    QPDFObjectHandle from;
+    if (left == i) {
+        from = right_node;
+        kid = right_kids[0];
+        right_kids.erase(0);
+        kids.push_back(kid);
+    } else {
+        from = left_node;
+        kid = left_kids[left_kids.size() - 1];
+        left_kids.erase(left_kids.size() - 1);
+        kids.insert(0, kid);
+    }
+    auto count = page_count(kid);
+    kid.replaceKey("/Parent", node);
+    node.replaceKey("/Count", Integer(Integer(node["/Count"]).value<size_t>() + count));
+    from.replaceKey("/Count", Integer(Integer(from["/Count"]).value<size_t>() - count));
+}
+
+size_t
+Pages::tree_index(QPDFObjectHandle const& parent, QPDFObjectHandle const& node)
+{
+    // Return the position of node in its parent's /Kids.
+    Array kids = parent["/Kids"];
+    size_t i = 0;
+    for (auto const& kid: kids) {
+        if (kid.isSameObjectAs(node)) {
+            return i;
+        }
+        ++i;
+    }
+    throw std::logic_error("/Pages structure modified outside of page APIs");
+}
+
+size_t
+Pages::tree_find(QPDFObjectHandle node)
+{
+    // Add up the pages preceding each node on the path from the page to the root.
+    auto root = qpdf.getRoot()["/Pages"];
+    size_t pos = 0;
+    for (uint32_t level = 0; !node.isSameObjectAs(root); ++level) {
+        util::assertion(level < 100, "/Pages structure modified outside of page APIs");
+        auto parent = node["/Parent"];
+        for (auto const& kid: Array(parent["/Kids"])) {
+            if (kid.isSameObjectAs(node)) {
+                break;
+            }
+            pos += page_count(kid);
+        }
+        node = parent;
+    }
+    return pos;
+}
+
 void
 QPDF::pushInheritedAttributesToPage()
 {
@@ -463,7 +835,12 @@ Pages::insert(QPDFObjectHandle newpage, int pos)
     if (!newpage.indirect()) {
         newpage = qpdf.makeIndirectObject(newpage);
     } else if (newpage.qpdf() != &qpdf) {
-        newpage.qpdf()->pushInheritedAttributesToPage();
+        // Pages obtained with locate in lazy mode already carry their inherited attributes.
+        // Pushing them down for the whole source document would read its entire pages tree.
+        auto& source = newpage.qpdf()->doc().pages();
+        if (!(source.lazy_ && source.all_pages.empty())) {
+            newpage.qpdf()->pushInheritedAttributesToPage();
+        }
         newpage = qpdf.copyForeignObject(newpage);
     } else {
         QTC::TC("qpdf", "QPDF insert indirect page");
@@ -480,10 +857,17 @@ Pages::insert(QPDFObjectHandle newpage, int pos)
             std::cmp_equal(pos, size()) ? 1   // at end
                                         : 2); // insert in middle
 
-    if (pageobj_to_pages_pos.contains(newpage)) {
+    if (contains(newpage)) {
         newpage = qpdf.makeIndirectObject(newpage.copy());
     }
 
+    if (tree_fanout_) {
+        tree_insert(newpage, toS(pos));
+        tree_pages_.add(newpage);
+        all_pages.insert(all_pages.begin() + pos, newpage);
+        return;
+    }
+
     auto pages = qpdf.getRoot()["/Pages"];
     Array kids = pages["/Kids"];
 
@@ -515,6 +899,13 @@ Pages::erase(QPDFObjectHandle& page)
             (pos == toI(all_pages.size() - 1)) ? 1   // end
                                                : 2); // remove in middle
 
+    if (tree_fanout_) {
+        tree_erase(page);
+        tree_pages_.erase(page);
+        all_pages.erase(all_pages.begin() + pos);
+        return;
+    }
+
     QPDFObjectHandle pages = qpdf.getRoot().getKey("/Pages");
     QPDFObjectHandle kids = pages.getKey("/Kids");
 
@@ -560,12 +951,17 @@ QPDF::findPage(QPDFObjGen og)
     return m->pages.find(og);
 }
 
+bool
+Pages::contains(QPDFObjGen og) const
+{
+    return tree_fanout_ ? tree_pages_.contains(og) : pageobj_to_pages_pos.contains(og);
+}
+
 int
 Pages::find(QPDFObjGen og)
 {
     flattenPagesTree();
-    auto it = pageobj_to_pages_pos.find(og);
-    if (it == pageobj_to_pages_pos.end()) {
+    if (!contains(og)) {
         throw QPDFExc(
             qpdf_e_pages,
             m->file->getName(),
@@ -573,7 +969,10 @@ Pages::find(QPDFObjGen og)
             0,
             "page object not referenced in /Pages tree");
     }
-    return (*it).second;
+    if (tree_fanout_) {
+        return toI(tree_find(qpdf.getObject(og)));
+    }
+    return pageobj_to_pages_pos.find(og)->second;
 }
 
 class QPDFPageDocumentHelper::Members
@@ -2,30 +2,25 @@
 
 #include <qpdf/QUtil.hh>
 #include <cstdio>
-#include <map>
+#include <mutex>
 #include <set>
-
-static bool
-tc_active(char const* const scope)
-{
-    std::string value;
-    return (QUtil::get_env("TC_SCOPE", &value) && (value == scope));
-}
+#include <string>
 
 void
 QTC::TC_real(char const* const scope, char const* const ccase, int n)
 {
-    static std::map<std::string, bool> active;
-    auto is_active = active.find(scope);
-    if (is_active == active.end()) {
-        active[scope] = tc_active(scope);
-        is_active = active.find(scope);
-    }
-
-    if (!is_active->second) {
+    // Coverage cases may be reached from more than one thread, so the scope is only read once, and
+    // the cache and output file are protected by a mutex.
+    static std::string const active_scope = [] {
+        std::string value;
+        return QUtil::get_env("TC_SCOPE", &value) ? value : std::string();
+    }();
+    if (active_scope.empty() || active_scope != scope) {
         return;
     }
 
+    static std::mutex mutex;
+    std::lock_guard lock(mutex);
     static std::set<std::pair<std::string, int>> cache;
 
     std::string filename;
@@ -0,0 +1,232 @@
+#include <qpdf/ReadAheadInputSource.hh>
+
+#include <qpdf/QIntC.hh>
+#include <qpdf/Util.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace qpdf;
+
+class ReadAheadInputSource::Members
+{
+  public:
+    Members(std::shared_ptr<InputSource> source, size_t block_size, size_t max_blocks) :
+        source(source),
+        block_size(std::max(block_size, size_t(1))),
+        max_blocks(std::max(max_blocks, size_t(1))),
+        pos(source->tell())
+    {
+    }
+
+    struct Block
+    {
+        qpdf_offset_t start{-1};
+        std::string data;
+        size_t last_used{0};
+    };
+
+    size_t
+    underlying(qpdf_offset_t offset, char* buffer, size_t length)
+    {
+        auto len = source->readAt(offset, buffer, length);
+        ++reads;
+        bytes += len;
+        return len;
+    }
+
+    // Return the block that contains offset, reading it if it is not cached. When the cache is
+    // full, the least recently used block is replaced.
+    Block const&
+    block(qpdf_offset_t offset)
+    {
+        auto start = offset - offset % QIntC::to_offset(block_size);
+        ++clock;
+        auto found = std::find_if(
+            blocks.begin(), blocks.end(), [start](auto const& b) { return b.start == start; });
+        if (found == blocks.end()) {
+            if (blocks.size() < max_blocks) {
+                found = blocks.emplace(blocks.end());
+            } else {
+                found = std::min_element(blocks.begin(), blocks.end(), [](auto& a, auto& b) {
+                    return a.last_used < b.last_used;
+                });
+            }
+            found->start = start;
+            found->data.resize(block_size);
+            found->data.resize(underlying(start, found->data.data(), block_size));
+        }
+        found->last_used = clock;
+        return *found;
+    }
+
+    qpdf_offset_t
+    end()
+    {
+        if (!size) {
+            source->seek(0, SEEK_END);
+            size = source->tell();
+        }
+        return *size;
+    }
+
+    std::shared_ptr<InputSource> source;
+    size_t block_size;
+    size_t max_blocks;
+    std::vector<Block> blocks;
+    size_t clock{0};
+    qpdf_offset_t pos;
+    std::optional<qpdf_offset_t> size;
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> bytes{0};
+};
+
+ReadAheadInputSource::ReadAheadInputSource(
+    std::shared_ptr<InputSource> source, size_t block_size, size_t max_blocks) :
+    m(std::make_unique<Members>(source, block_size, max_blocks))
+{
+    last_offset = m->pos;
+}
+
+ReadAheadInputSource::~ReadAheadInputSource() // NOLINT (modernize-use-equals-default)
+{
+    // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
+}
+
+qpdf_offset_t
+ReadAheadInputSource::findAndSkipNextEOL()
+{
+    qpdf_offset_t result = 0;
+    bool done = false;
+    char buf[1024];
+    while (!done) {
+        qpdf_offset_t cur_offset = m->pos;
+        size_t len = read(buf, sizeof(buf));
+        if (len == 0) {
+            done = true;
+            result = tell();
+        } else {
+            char* p1 = static_cast<char*>(memchr(buf, '\r', len));
+            char* p2 = static_cast<char*>(memchr(buf, '\n', len));
+            char* p = (p1 && p2) ? std::min(p1, p2) : p1 ? p1 : p2;
+            if (p) {
+                result = cur_offset + (p - buf);
+                // We found \r or \n.  Keep reading until we get past \r and \n characters.
+                seek(result + 1, SEEK_SET);
+                char ch;
+                while (!done) {
+                    if (read(&ch, 1) == 0) {
+                        done = true;
+                    } else if (!((ch == '\r') || (ch == '\n'))) {
+                        unreadCh(ch);
+                        done = true;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::string const&
+ReadAheadInputSource::getName() const
+{
+    return m->source->getName();
+}
+
+qpdf_offset_t
+ReadAheadInputSource::tell()
+{
+    return m->pos;
+}
+
+void
+ReadAheadInputSource::seek(qpdf_offset_t offset, int whence)
+{
+    qpdf_offset_t pos = offset;
+    switch (whence) {
+    case SEEK_SET:
+        break;
+
+    case SEEK_END:
+        QIntC::range_check(m->end(), offset);
+        pos = m->end() + offset;
+        break;
+
+    default:
+        util::assertion(whence == SEEK_CUR, "invalid argument to ReadAheadInputSource::seek");
+        QIntC::range_check(m->pos, offset);
+        pos = m->pos + offset;
+    }
+    if (pos < 0) {
+        throw std::runtime_error(getName() + ": seek before beginning of file");
+    }
+    m->pos = pos;
+}
+
+void
+ReadAheadInputSource::rewind()
+{
+    m->pos = 0;
+}
+
+size_t
+ReadAheadInputSource::read(char* buffer, size_t length)
+{
+    last_offset = m->pos;
+    size_t len = 0;
+    if (length >= m->block_size) {
+        len = m->underlying(m->pos, buffer, length);
+    } else {
+        while (len < length) {
+            auto offset = m->pos + QIntC::to_offset(len);
+            auto const& block = m->block(offset);
+            auto in_block = QIntC::to_size(offset - block.start);
+            if (in_block >= block.data.size()) {
+                break;
+            }
+            auto count = std::min(block.data.size() - in_block, length - len);
+            memcpy(buffer + len, block.data.data() + in_block, count);
+            len += count;
+        }
+    }
+    if (len == 0 && length > 0) {
+        // As with FileInputSource, reading at or past the end leaves the position at the end.
+        m->pos = m->end();
+        last_offset = m->pos;
+    } else {
+        m->pos += QIntC::to_offset(len);
+    }
+    return len;
+}
+
+void
+ReadAheadInputSource::unreadCh(char ch)
+{
+    if (m->pos > 0) {
+        --m->pos;
+    }
+}
+
+size_t
+ReadAheadInputSource::getUnderlyingReads() const
+{
+    return m->reads;
+}
+
+size_t
+ReadAheadInputSource::getUnderlyingBytes() const
+{
+    return m->bytes;
+}
+
+size_t
+ReadAheadInputSource::read_at(qpdf_offset_t offset, char* buffer, size_t length)
+{
+    // Positional reads may come from several threads at once, so they bypass the cache.
+    return m->underlying(offset, buffer, length);
+}
@@ -0,0 +1,109 @@
+#include <qpdf/WorkerPool.hh>
+
+#include <algorithm>
+#include <system_error>
+
+using namespace qpdf;
+
+WorkerPool::WorkerPool(size_t size) :
+    size_(size ? size : std::max(1U, std::thread::hardware_concurrency()))
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+}
+
+void
+WorkerPool::start(size_t wanted)
+{
+    while (threads.size() < wanted) {
+        try {
+            threads.emplace_back(&WorkerPool::work, this);
+        } catch (std::system_error&) {
+            // Make do with the threads that could be created.
+            return;
+        }
+    }
+}
+
+void
+WorkerPool::run(size_t n, std::function<void(size_t)> const& fn)
+{
+    if (n == 0) {
+        return;
+    }
+    start(std::min(n, size_) - 1);
+    std::unique_lock lock(mutex);
+    task = &fn;
+    count = n;
+    next = 0;
+    error = nullptr;
+    ++generation;
+    ++active;
+    lock.unlock();
+    wake.notify_all();
+    lock.lock();
+    while (next < count) {
+        auto i = next++;
+        lock.unlock();
+        try {
+            fn(i);
+        } catch (...) {
+            lock.lock();
+            if (!error) {
+                error = std::current_exception();
+            }
+            continue;
+        }
+        lock.lock();
+    }
+    --active;
+    done.wait(lock, [this] { return active == 0; });
+    task = nullptr;
+    if (error) {
+        std::exception_ptr e;
+        std::swap(e, error);
+        std::rethrow_exception(e);
+    }
+}
+
+void
+WorkerPool::work()
+{
+    size_t seen = 0;
+    std::unique_lock lock(mutex);
+    while (true) {
+        wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        ++active;
+        while (next < count) {
+            auto i = next++;
+            lock.unlock();
+            try {
+                (*task)(i);
+            } catch (...) {
+                lock.lock();
+                if (!error) {
+                    error = std::current_exception();
+                }
+                continue;
+            }
+            lock.lock();
+        }
+        if (--active == 0) {
+            done.notify_all();
+        }
+    }
+}
@@ -64,6 +64,7 @@ namespace qpdf::is
         }
 
         size_t read(char* buffer, size_t length) final;
+        size_t read_at(qpdf_offset_t offset, char* buffer, size_t length) const;
 
         void
         unreadCh(char ch) final
@@ -0,0 +1,26 @@
+#ifndef JSON_PRIVATE_HH
+#define JSON_PRIVATE_HH
+
+#include <qpdf/JSON.hh>
+
+#include <string>
+
+namespace qpdf::impl
+{
+    // A JSON::Reactor that can ask the parser not to keep the values of selected string items. This
+    // is used to read very large strings, such as base64-encoded stream data, directly from the
+    // input instead of holding them in memory while parsing.
+    class JSONStreamingReactor: public JSON::Reactor
+    {
+      public:
+        ~JSONStreamingReactor() override = default;
+
+        // Called when the value of the dictionary item 'key' is a string, before the string is
+        // parsed. If this returns true, the string is still checked for validity, but its value is
+        // not accumulated, and the value passed to dictionaryItem is an empty string whose start
+        // and end offsets are those of the string in the input.
+        virtual bool skipStringValue(std::string const& key) = 0;
+    };
+} // namespace qpdf::impl
+
+#endif // JSON_PRIVATE_HH
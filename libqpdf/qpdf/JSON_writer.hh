@@ -6,6 +6,7 @@
 #include <qpdf/Pl_Base64.hh>
 #include <qpdf/Pl_Concatenate.hh>
 
+#include <charconv>
 #include <string_view>
 
 // Writer is a small utility class to aid writing JSON to a pipeline. Methods are designed to allow
@@ -102,15 +103,19 @@ class JSON::Writer
     Writer&
     operator<<(int val)
     {
-        *this << std::to_string(val);
-        return *this;
+        return write_number(val);
+    }
+
+    Writer&
+    operator<<(long long val)
+    {
+        return write_number(val);
     }
 
     Writer&
     operator<<(size_t val)
     {
-        *this << std::to_string(val);
-        return *this;
+        return write_number(val);
     }
 
     Writer&
@@ -120,9 +125,39 @@ class JSON::Writer
         return *this;
     }
 
+    // A string to be written with JSON escapes applied, created by 'encoded'. Writing it avoids
+    // creating the encoded string as a temporary.
+    struct Encoded
+    {
+        std::string_view utf8;
+    };
+
+    static Encoded
+    encoded(std::string_view utf8)
+    {
+        return {utf8};
+    }
+
+    Writer&
+    operator<<(Encoded e)
+    {
+        write_encoded(p, e.utf8);
+        return *this;
+    }
+
     static std::string encode_string(std::string const& utf8);
+    static void write_encoded(Pipeline* p, std::string_view utf8);
 
   private:
+    template <typename T>
+    Writer&
+    write_number(T val)
+    {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), val);
+        return write(buf, static_cast<size_t>(result.ptr - buf));
+    }
+
     Pipeline* p;
     bool first{true};
     size_t indent;
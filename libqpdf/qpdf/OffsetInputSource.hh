@@ -19,6 +19,7 @@ class OffsetInputSource: public InputSource
     void rewind() override;
     size_t read(char* buffer, size_t length) override;
     void unreadCh(char ch) override;
+    size_t read_at(qpdf_offset_t offset, char* buffer, size_t length);
 
   private:
     std::shared_ptr<InputSource> proxied;
@@ -16,8 +16,11 @@ class Pl_Base64 final: public Pipeline
     static std::string decode(std::string_view data);
 
   private:
+    // Process all complete groups of input characters, leaving any remaining characters in buf.
     void decode_internal(std::string_view data);
     void encode_internal(std::string_view data);
+    // Process the remaining characters at the end of the input.
+    void finish_internal();
     void flush_decode();
     void flush_encode();
     void reset();
@@ -25,7 +28,6 @@ class Pl_Base64 final: public Pipeline
     action_e action;
     unsigned char buf[4]{0, 0, 0, 0};
     size_t pos{0};
-    std::string in_buffer;
     std::string out_buffer;
     bool end_of_data{false};
 };
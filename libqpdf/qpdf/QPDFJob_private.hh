@@ -39,6 +39,8 @@ struct QPDFJob::Selection
 struct QPDFJob::Input
 {
     void initialize(QPDFJob& job, Inputs& in, QPDF* qpdf = nullptr);
+    bool locate(std::vector<int> const& pagenos);
+    void load_all(QPDFJob& job);
 
     std::string password;
     std::unique_ptr<QPDF> qpdf_p;
@@ -48,6 +50,8 @@ struct QPDFJob::Input
     int n_pages;
     std::vector<bool> copied_pages;
     bool remove_unreferenced{false};
+    // With --lazy-page-access, orig_pages only contains the pages that have been located.
+    bool lazy{false};
 };
 
 // All PDF input files for a job.
@@ -82,6 +86,7 @@ struct QPDFJob::Inputs
     bool keep_files_open{true};
     bool keep_files_open_set{false};
     size_t keep_files_open_threshold{DEFAULT_KEEP_FILES_OPEN_THRESHOLD};
+    bool lazy_page_access{false};
 
     std::map<std::string, Input> files;
     std::vector<Selection> selections;
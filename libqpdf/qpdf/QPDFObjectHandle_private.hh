@@ -685,6 +685,12 @@ namespace qpdf
         }
         bool isRootMetadata() const;
 
+        // Set filters to the filters needed to decode the stream at decode_level, and return
+        // whether the stream can be decoded at that level.
+        bool filterable(
+            qpdf_stream_decode_level_e decode_level,
+            std::vector<std::shared_ptr<QPDFStreamFilter>>& filters);
+
         void setDictDescription();
 
         static void registerStreamFilter(
@@ -704,9 +710,6 @@ namespace qpdf
             throw std::runtime_error("operation for stream attempted on non-stream object");
             return nullptr; // unreachable
         }
-        bool filterable(
-            qpdf_stream_decode_level_e decode_level,
-            std::vector<std::shared_ptr<QPDFStreamFilter>>& filters);
         void replaceFilterData(
             QPDFObjectHandle const& filter, QPDFObjectHandle const& decode_parms, size_t length);
 
@@ -197,6 +197,45 @@ namespace qpdf
 
             Config& extra_header_text(std::string const& val);
 
+            size_t
+            pages_tree_fanout() const
+            {
+                return pages_tree_fanout_;
+            }
+
+            Config&
+            pages_tree_fanout(size_t val)
+            {
+                pages_tree_fanout_ = val;
+                return *this;
+            }
+
+            bool
+            deduplicate_streams() const
+            {
+                return deduplicate_streams_;
+            }
+
+            Config&
+            deduplicate_streams(bool val)
+            {
+                deduplicate_streams_ = val;
+                return *this;
+            }
+
+            bool
+            deduplicate_objects() const
+            {
+                return deduplicate_objects_;
+            }
+
+            Config&
+            deduplicate_objects(bool val)
+            {
+                deduplicate_objects_ = val;
+                return *this;
+            }
+
             bool
             preserve_unreferenced() const
             {
@@ -297,6 +336,7 @@ namespace qpdf
             qpdf_stream_decode_level_e decode_level_{qpdf_dl_generalized};
 
             int forced_extension_level_{0};
+            size_t pages_tree_fanout_{0};
 
             bool normalize_content_set_{false};
             bool normalize_content_{false};
@@ -306,6 +346,8 @@ namespace qpdf
             bool recompress_flate_{false};
             bool qdf_{false};
             bool preserve_unreferenced_{false};
+            bool deduplicate_streams_{false};
+            bool deduplicate_objects_{false};
             bool newline_before_endstream_{false};
             bool deterministic_id_{false};
             bool static_id_{false};
@@ -16,6 +16,7 @@
 
 #include <cinttypes>
 #include <exception>
+#include <mutex>
 
 using namespace qpdf;
 
@@ -148,9 +149,51 @@ namespace qpdf
                 return *this;
             }
 
+            size_t
+            pages_tree_fanout() const
+            {
+                return pages_tree_fanout_;
+            }
+
+            Config&
+            pages_tree_fanout(size_t val)
+            {
+                pages_tree_fanout_ = val;
+                return *this;
+            }
+
+            std::string const&
+            xref_index_file() const
+            {
+                return xref_index_file_;
+            }
+
+            Config&
+            xref_index_file(std::string const& val)
+            {
+                xref_index_file_ = val;
+                return *this;
+            }
+
+            size_t
+            threads() const
+            {
+                return threads_;
+            }
+
+            Config&
+            threads(size_t val)
+            {
+                threads_ = val;
+                return *this;
+            }
+
           private:
             std::shared_ptr<QPDFLogger> log_;
+            std::string xref_index_file_;
             size_t max_warnings_{global::Limits::doc_max_warnings()};
+            size_t pages_tree_fanout_{0};
+            size_t threads_{0};
             bool password_is_hex_key_{false};
             bool ignore_xref_streams_{false};
             bool suppress_warnings_{false};
@@ -1033,6 +1076,12 @@ class QPDF::Doc::Objects: Common
         return uncompressed_after_compressed_;
     }
 
+    bool
+    used_xref_index() const
+    {
+        return used_xref_index_;
+    }
+
     bool
     root_checked() const
     {
@@ -1045,7 +1094,16 @@ class QPDF::Doc::Objects: Common
         root_checked_ = val;
     }
 
+    // Number of objects read from the input so far. All objects in an object stream are read when
+    // the first of them is resolved.
+    size_t
+    resolved_count() const
+    {
+        return resolved_count_;
+    }
+
     void parse(char const* password);
+    void write_xref_index(std::string const& filename);
     std::shared_ptr<QPDFObject> const& resolve(QPDFObjGen og);
     void inParse(bool);
     QPDFObjGen nextObjGen();
@@ -1057,6 +1115,12 @@ class QPDF::Doc::Objects: Common
         qpdf_offset_t end_after_space,
         bool destroy = true);
     bool resolveXRefTable();
+    // Return the objects in 'wanted' that exist, in object order, resolving only those objects.
+    // Unlike getAllObjects, this doesn't find references to objects that are missing from the
+    // xref table unless they have already been resolved.
+    std::vector<QPDFObjectHandle> select(std::set<QPDFObjGen> const& wanted);
+    // The highest object number known without resolving all objects.
+    int known_max_id() const;
     QPDFObjectHandle readObjectAtOffset(
         qpdf_offset_t offset, std::string const& description, bool skip_cache_if_in_xref);
     QPDFTokenizer::Token readToken(InputSource& input, size_t max_len = 0);
@@ -1081,6 +1145,8 @@ class QPDF::Doc::Objects: Common
     std::vector<T> compressible();
 
     void setTrailer(QPDFObjectHandle obj);
+    std::string xref_index_key();
+    bool read_xref_index();
     void reconstruct_xref(QPDFExc& e, bool found_startxref = true);
     void read_xref(qpdf_offset_t offset, bool in_stream_recovery = false);
     bool parse_xrefFirst(std::string const& line, int& obj, int& num, int& bytes);
@@ -1130,6 +1196,9 @@ class QPDF::Doc::Objects: Common
     qpdf_offset_t first_xref_item_offset_{0}; // actual value from file
     bool uncompressed_after_compressed_{false};
     bool root_checked_{false};
+    bool used_xref_index_{false};
+
+    size_t resolved_count_{0};
 }; // class QPDF::Doc::Objects
 
 // This class is used to represent a PDF Pages tree.
@@ -1205,9 +1274,57 @@ class QPDF::Doc::Pages: Common
 
     void pushInheritedAttributesToPage(bool allow_changes, bool warn_skipped_keys);
 
+    // Push inherited attributes down to the pages and rebuild the /Pages tree as a balanced tree
+    // in which no /Pages node has more than `fanout` kids, or flatten it if `fanout` is 0. From
+    // then on, the tree is maintained in that shape by insert and erase until the cache is
+    // updated. Nothing is done if the tree is already being maintained with the same fanout.
+    void balance(size_t fanout);
+
+    // Minimal touch page access. In lazy mode, isPageObject and isPagesObject do not force a
+    // traversal of the complete pages tree, and pages can be located individually by descending
+    // the tree using the /Count entries of the /Pages nodes. See comments in QPDF_pages.cc.
+    bool
+    lazy() const
+    {
+        return lazy_;
+    }
+
+    void
+    lazy(bool val)
+    {
+        lazy_ = val;
+    }
+
+    // Return the number of pages according to the /Count entry of the root of the pages tree, or
+    // 0 if it is missing or invalid.
+    size_t declared_size();
+
+    // Return the page at position pos (from 0). In lazy mode, unless the pages have already been
+    // cached, only the /Pages nodes on the path to the page are visited. Return a null object if
+    // the page can't be located that way, in which case the caller should fall back to all().
+    QPDFObjectHandle locate(size_t pos);
+
   private:
-    void flattenPagesTree();
+    void
+    flattenPagesTree()
+    {
+        flattenPagesTree(cf.pages_tree_fanout());
+    }
+    void flattenPagesTree(size_t fanout);
     void insertPageobjToPage(QPDFObjectHandle const& obj, int pos, bool check_duplicate);
+    bool contains(QPDFObjGen og) const;
+
+    // Methods to maintain a balanced pages tree. See comments in QPDF_pages.cc.
+    void build_tree();
+    QPDFObjectHandle
+    tree_node(std::vector<QPDFObjectHandle> const& kids, QPDFObjectHandle const& parent);
+    void tree_insert(QPDFObjectHandle newpage, size_t pos);
+    void tree_erase(QPDFObjectHandle const& page);
+    size_t tree_find(QPDFObjectHandle node);
+    size_t tree_index(QPDFObjectHandle const& parent, QPDFObjectHandle const& node);
+    void tree_count(QPDFObjectHandle node, int delta);
+    void tree_split(QPDFObjectHandle node);
+    void tree_join(QPDFObjectHandle node);
     void pushInheritedAttributesToPageInternal(
         QPDFObjectHandle,
         std::map<std::string, std::vector<QPDFObjectHandle>>&,
@@ -1231,10 +1348,16 @@ class QPDF::Doc::Pages: Common
     std::vector<QPDFObjectHandle> all_pages;
     std::map<QPDFObjGen, int> pageobj_to_pages_pos;
 
+    // Balanced pages tree: the fanout is 0 unless the pages tree has been prepared for modification
+    // as a balanced tree, in which case tree_pages_ replaces pageobj_to_pages_pos.
+    size_t tree_fanout_{0};
+    QPDFObjGen::set tree_pages_;
+
     bool pushed_inherited_attributes_to_pages{false};
     bool invalid_page_found{false};
     bool ever_pushed_inherited_attributes_to_pages_{false};
     bool ever_called_get_all_pages_{false};
+    bool lazy_{false};
 
 }; // class QPDF::Doc::Pages
 
@@ -1269,6 +1392,13 @@ class QPDF::Members: Doc
     std::set<QPDFObjGen> resolving;
     QPDFObjectHandle trailer;
     std::vector<QPDFExc> warnings;
+    // Once all objects have been resolved (see makeReadOnlySnapshot), the remaining shared state
+    // that readers on several threads can touch is the encryption key cache and the list of
+    // warnings. These are only accessed while holding the corresponding mutex. Stream data is read
+    // with positional reads, which don't need a lock.
+    std::mutex encryption_mutex;
+    std::mutex warnings_mutex;
+    bool read_only_snapshot{false};
     bool reconstructed_xref{false};
     bool in_read_xref_stream{false};
     bool fixed_dangling_refs{false};
@@ -0,0 +1,57 @@
+#ifndef WORKERPOOL_HH
+#define WORKERPOOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qpdf
+{
+    // A fixed set of worker threads that is reused for any number of calls to run. The calling
+    // thread takes part in the work, so a pool of size n creates at most n - 1 threads. Threads are
+    // created on first use. If a thread can't be created, the pool makes do with the threads it
+    // has, down to running everything on the calling thread.
+    class WorkerPool final
+    {
+      public:
+        // A size of 0 selects the number of hardware threads.
+        explicit WorkerPool(size_t size);
+        WorkerPool(WorkerPool const&) = delete;
+        WorkerPool& operator=(WorkerPool const&) = delete;
+        ~WorkerPool();
+
+        size_t
+        size() const
+        {
+            return size_;
+        }
+
+        // Call task(i) for each i in [0, count), using up to size() threads, and return when all
+        // calls have returned. If any call throws, the first exception is rethrown once all calls
+        // have finished.
+        void run(size_t count, std::function<void(size_t)> const& task);
+
+      private:
+        void work();
+        void start(size_t count);
+
+        size_t size_;
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::function<void(size_t)> const* task{nullptr};
+        size_t count{0};
+        size_t next{0};
+        size_t active{0};
+        size_t generation{0};
+        bool stopping{false};
+        std::exception_ptr error;
+    };
+} // namespace qpdf
+
+#endif // WORKERPOOL_HH
@@ -35,7 +35,7 @@ R"~()~",
 R"~(    # BEGIN GENERATED)~",
     R"~(    opts[help]="--version --copyright --show-crypto --job-json-help --zopfli --json-help --completion-bash --completion-zsh --help")~",
     R"~(    opts[global]="--no-default-limits --parser-max-container-size --parser-max-container-size-damaged --parser-max-errors --parser-max-nesting --max-stream-filters")~",
-    R"~(    opts[main]="--add-attachment --allow-weak-crypto --check --check-linearization --coalesce-contents --copy-attachments-from --decrypt --deterministic-id --empty --encrypt --externalize-inline-images --filtered-stream-data --flatten-rotation --generate-appearances --global --ignore-xref-streams --is-encrypted --json-input --keep-inline-images --linearize --list-attachments --newline-before-endstream --no-original-object-ids --no-warn --optimize-images --overlay --pages --password-is-hex-key --preserve-unreferenced --preserve-unreferenced-resources --progress --qdf --raw-stream-data --recompress-flate --remove-acroform --remove-info --remove-metadata --remove-page-labels --remove-structure --replace-input --report-memory-usage --requires-password --remove-restrictions --set-page-labels --show-encryption --show-encryption-key --show-linearization --show-npages --show-pages --show-xref --static-aes-iv --static-id --suppress-password-recovery --suppress-recovery --test-json-schema --underlay --verbose --warning-exit-0 --with-images --compression-level --jpeg-quality --encryption-file-password --force-version --ii-min-bytes --json-object --keep-files-open-threshold --min-version --oi-min-area --oi-min-height --oi-min-width --password --remove-attachment --rotate --show-attachment --show-object --copy-encryption --job-json-file --linearize-pass1 --password-file --update-from-json --json-stream-prefix --collate --split-pages --compress-streams --decode-level --flatten-annotations --json-key --json-stream-data --keep-files-open --normalize-content --object-streams --password-mode --remove-unreferenced-resources --stream-data --json --json-output")~",
+    R"~(    opts[main]="--add-attachment --allow-weak-crypto --check --check-linearization --coalesce-contents --copy-attachments-from --decrypt --deduplicate-objects --deduplicate-streams --deterministic-id --empty --encrypt --externalize-inline-images --filtered-stream-data --flatten-rotation --generate-appearances --global --ignore-xref-streams --is-encrypted --json-input --keep-inline-images --lazy-page-access --linearize --list-attachments --newline-before-endstream --no-original-object-ids --no-warn --optimize-images --overlay --pages --password-is-hex-key --preserve-unreferenced --preserve-unreferenced-resources --progress --qdf --raw-stream-data --recompress-flate --remove-acroform --remove-info --remove-metadata --remove-page-labels --remove-structure --replace-input --report-memory-usage --requires-password --remove-restrictions --set-page-labels --show-encryption --show-encryption-key --show-linearization --show-npages --show-pages --show-xref --static-aes-iv --static-id --suppress-password-recovery --suppress-recovery --test-json-schema --underlay --verbose --warning-exit-0 --with-images --compression-level --jpeg-quality --encryption-file-password --force-version --ii-min-bytes --json-object --keep-files-open-threshold --min-version --oi-min-area --oi-min-height --oi-min-width --pages-tree-fanout --password --remove-attachment --rotate --show-attachment --show-object --threads --copy-encryption --job-json-file --linearize-pass1 --password-file --update-from-json --json-stream-prefix --collate --split-pages --compress-streams --decode-level --flatten-annotations --json-key --json-stream-data --keep-files-open --normalize-content --object-streams --password-mode --remove-unreferenced-resources --stream-data --json --json-output")~",
     R"~(    opts[pages]="--range --password --file")~",
     R"~(    opts[encryption]="--user-password --owner-password --bits")~",
     R"~(    opts[40-bit-encryption]="--extract --annotate --print --modify")~",
@@ -64,6 +64,8 @@ R"~(    # BEGIN GENERATED)~",
     R"~(    _def main --coalesce-contents bare "none" "")~",
     R"~(    _def main --copy-attachments-from bare "none" "copy-attachment")~",
     R"~(    _def main --decrypt bare "none" "")~",
+    R"~(    _def main --deduplicate-objects bare "none" "")~",
+    R"~(    _def main --deduplicate-streams bare "none" "")~",
     R"~(    _def main --deterministic-id bare "none" "")~",
     R"~(    _def main --empty bare "none" "")~",
     R"~(    _def main --encrypt bare "none" "encryption")~",
@@ -76,6 +78,7 @@ R"~(    # BEGIN GENERATED)~",
     R"~(    _def main --is-encrypted bare "none" "")~",
     R"~(    _def main --json-input bare "none" "")~",
     R"~(    _def main --keep-inline-images bare "none" "")~",
+    R"~(    _def main --lazy-page-access bare "none" "")~",
     R"~(    _def main --linearize bare "none" "")~",
     R"~(    _def main --list-attachments bare "none" "")~",
     R"~(    _def main --newline-before-endstream bare "none" "")~",
@@ -127,11 +130,13 @@ R"~(    # BEGIN GENERATED)~",
     R"~(    _def main --oi-min-area req "none" "")~",
     R"~(    _def main --oi-min-height req "none" "")~",
     R"~(    _def main --oi-min-width req "none" "")~",
+    R"~(    _def main --pages-tree-fanout req "none" "")~",
     R"~(    _def main --password req "none" "")~",
     R"~(    _def main --remove-attachment req "none" "")~",
     R"~(    _def main --rotate req "none" "")~",
     R"~(    _def main --show-attachment req "none" "")~",
     R"~(    _def main --show-object req "none" "")~",
+    R"~(    _def main --threads req "none" "")~",
     R"~(    _def main --copy-encryption req "file" "")~",
     R"~(    _def main --job-json-file req "file" "")~",
     R"~(    _def main --linearize-pass1 req "file" "")~",
@@ -143,7 +148,7 @@ R"~(    # BEGIN GENERATED)~",
     R"~(    _def main --compress-streams req "y n" "")~",
     R"~(    _def main --decode-level req "none generalized specialized all" "")~",
     R"~(    _def main --flatten-annotations req "all print screen" "")~",
-    R"~(    _def main --json-key req "acroform attachments encrypt objectinfo objects outlines pagelabels pages qpdf" "")~",
+    R"~(    _def main --json-key req "acroform attachments encrypt objectinfo objects outlines pagelabels pages qpdf streamdigests" "")~",
     R"~(    _def main --json-stream-data req "none inline file" "")~",
     R"~(    _def main --keep-files-open req "y n" "")~",
     R"~(    _def main --normalize-content req "y n" "")~",
@@ -199,7 +204,7 @@ R"~(    # BEGIN GENERATED)~",
     R"~(    _def attachment --description req "none" "")~",
     R"~(    _def copy-attachment --prefix req "none" "")~",
     R"~(    _def copy-attachment --password req "none" "")~",
-    R"~(    _def help --help opt "--accessibility --add-attachment --allow-insecure --allow-weak-crypto --annotate --assemble --bits --check --check-linearization --cleartext-metadata --coalesce-contents --collate --completion-bash --completion-zsh --compress-streams --compression-level --copy-attachments-from --copy-encryption --copyright --creationdate --decode-level --decrypt --description --deterministic-id --empty --encrypt --encryption-file-password --externalize-inline-images --extract --file --filename --filtered-stream-data --flatten-annotations --flatten-rotation --force-R5 --force-V4 --force-version --form --from --generate-appearances --global --help --ignore-xref-streams --ii-min-bytes --is-encrypted --job-json-file --job-json-help --jpeg-quality --json --json-help --json-input --json-key --json-object --json-output --json-stream-data --json-stream-prefix --keep-files-open --keep-files-open-threshold --keep-inline-images --key --linearize --linearize-pass1 --list-attachments --max-stream-filters --mimetype --min-version --moddate --modify --modify-other --newline-before-endstream --no-default-limits --no-original-object-ids --no-warn --normalize-content --object-streams --oi-min-area --oi-min-height --oi-min-width --optimize-images --overlay --owner-password --pages --parser-max-container-size --parser-max-container-size-damaged --parser-max-errors --parser-max-nesting --password --password-file --password-is-hex-key --password-mode --prefix --preserve-unreferenced --preserve-unreferenced-resources --print --progress --qdf --range --raw-stream-data --recompress-flate --remove-acroform --remove-attachment --remove-info --remove-metadata --remove-page-labels --remove-restrictions --remove-structure --remove-unreferenced-resources --repeat --replace --replace-input --report-memory-usage --requires-password --rotate --set-page-labels --show-attachment --show-crypto --show-encryption --show-encryption-key --show-linearization --show-npages --show-object --show-pages --show-xref --split-pages --static-aes-iv --static-id --stream-data --suppress-password-recovery --suppress-recovery --test-json-schema --to --underlay --update-from-json --use-aes --user-password --verbose --version --warning-exit-0 --with-images --zopfli add-attachment advanced-control all attachments completion copy-attachments encryption exit-status general global help inspection json modification overlay-underlay page-ranges page-selection pdf-dates testing transformation usage" "")~",
+    R"~(    _def help --help opt "--accessibility --add-attachment --allow-insecure --allow-weak-crypto --annotate --assemble --bits --check --check-linearization --cleartext-metadata --coalesce-contents --collate --completion-bash --completion-zsh --compress-streams --compression-level --copy-attachments-from --copy-encryption --copyright --creationdate --decode-level --decrypt --deduplicate-objects --deduplicate-streams --description --deterministic-id --empty --encrypt --encryption-file-password --externalize-inline-images --extract --file --filename --filtered-stream-data --flatten-annotations --flatten-rotation --force-R5 --force-V4 --force-version --form --from --generate-appearances --global --help --ignore-xref-streams --ii-min-bytes --is-encrypted --job-json-file --job-json-help --jpeg-quality --json --json-help --json-input --json-key --json-object --json-output --json-stream-data --json-stream-prefix --keep-files-open --keep-files-open-threshold --keep-inline-images --key --lazy-page-access --linearize --linearize-pass1 --list-attachments --max-stream-filters --mimetype --min-version --moddate --modify --modify-other --newline-before-endstream --no-default-limits --no-original-object-ids --no-warn --normalize-content --object-streams --oi-min-area --oi-min-height --oi-min-width --optimize-images --overlay --owner-password --pages --pages-tree-fanout --parser-max-container-size --parser-max-container-size-damaged --parser-max-errors --parser-max-nesting --password --password-file --password-is-hex-key --password-mode --prefix --preserve-unreferenced --preserve-unreferenced-resources --print --progress --qdf --range --raw-stream-data --recompress-flate --remove-acroform --remove-attachment --remove-info --remove-metadata --remove-page-labels --remove-restrictions --remove-structure --remove-unreferenced-resources --repeat --replace --replace-input --report-memory-usage --requires-password --rotate --set-page-labels --show-attachment --show-crypto --show-encryption --show-encryption-key --show-linearization --show-npages --show-object --show-pages --show-xref --split-pages --static-aes-iv --static-id --stream-data --suppress-password-recovery --suppress-recovery --test-json-schema --threads --to --underlay --update-from-json --use-aes --user-password --verbose --version --warning-exit-0 --with-images --zopfli add-attachment advanced-control all attachments completion copy-attachments encryption exit-status general global help inspection json modification overlay-underlay page-ranges page-selection pdf-dates testing transformation usage" "")~",
     R"~(    _def help --completion-bash bare "none" "")~",
     R"~(    _def help --completion-zsh bare "none" "")~",
     R"~(    vnext[encryption.--bits.40]=40-bit-encryption)~",
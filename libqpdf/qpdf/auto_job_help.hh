@@ -125,6 +125,21 @@ ap.addOptionHelp("--keep-files-open-threshold", "general", "set threshold for --
 Set the threshold used by --keep-files-open, overriding the
 default value of 200.
 )");
+ap.addOptionHelp("--lazy-page-access", "general", "only read what is needed to copy selected pages", R"(When selecting pages from files other than the primary input
+file, locate the selected pages by following the /Count entries
+of the pages tree instead of reading all pages, and only read
+objects that are reachable from the selected pages. With
+--verbose, the number of objects read from each such file is
+shown.
+)");
+ap.addOptionHelp("--threads", "general", "maximum number of threads for parallel work", R"(--threads=count
+
+Use at most this many threads for work that qpdf can do in
+parallel, such as --optimize-images and reconstructing the
+cross-reference table of large damaged files. The default of
+0 uses one thread per available processor. Use 1 to do
+everything on a single thread.
+)");
 ap.addHelpTopic("advanced-control", "tweak qpdf's behavior", R"(Advanced control options control qpdf's behavior in ways that would
 normally never be needed by a user but that may be useful to
 developers or people investigating problems with specific files.
@@ -161,6 +176,9 @@ ap.addOptionHelp("--decrypt", "transformation", "remove encryption from input fi
 encrypted. Normally qpdf preserves whatever encryption was
 present on the input file. This option overrides that behavior.
 )");
+}
+static void add_help_3(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--remove-restrictions", "transformation", "remove security restrictions from input file", R"(Remove restrictions associated with digitally signed PDF files.
 This may be combined with --decrypt to allow free editing of
 previously signed/encrypted files. This option invalidates and
@@ -173,9 +191,6 @@ Copy encryption details from the specified file instead of
 preserving the input file's encryption. Use --encryption-file-password
 to specify the encryption file's password.
 )");
-}
-static void add_help_3(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--encryption-file-password", "transformation", "supply password for --copy-encryption", R"(--encryption-file-password=password
 
 If the file named in --copy-encryption requires a password, use
@@ -261,8 +276,27 @@ Control what qpdf does regarding object streams. Options:
 - disable: create output files with no object streams
 - generate: create object streams, and compress objects when possible
 )");
+ap.addOptionHelp("--pages-tree-fanout", "transformation", "write a balanced pages tree", R"(--pages-tree-fanout=count
+
+Rebuild the pages tree as a balanced tree in which no node
+has more than the given number of kids. Inherited attributes
+are pushed down to the pages.
+)");
 ap.addOptionHelp("--preserve-unreferenced", "transformation", "preserve unreferenced objects", R"(Preserve all objects from the input even if not referenced.
 )");
+ap.addOptionHelp("--deduplicate-streams", "transformation", "write identical streams only once", R"(Before writing, find streams that have the same dictionary,
+apart from /Length, and the same data, and replace references
+to all but one of them with references to the one with the
+lowest object number. With --verbose, the number of duplicate
+streams and the number of bytes saved are shown.
+)");
+ap.addOptionHelp("--deduplicate-objects", "transformation", "write identical non-stream objects only once", R"(Before writing, find indirect objects other than streams that
+have the same value and replace references to all but one of
+them with references to the one with the lowest object number.
+Pages, annotations, form fields, outlines, and structure tree
+nodes are never merged. With --verbose, the number of duplicate
+objects is shown.
+)");
 ap.addOptionHelp("--remove-unreferenced-resources", "transformation", "remove unreferenced page resources", R"(--remove-unreferenced-resources=parameter
 
 Remove from a page's resource dictionary any resources that are
@@ -271,6 +305,9 @@ not referenced in the page's contents. Parameters: "auto"
 )");
 ap.addOptionHelp("--preserve-unreferenced-resources", "transformation", "use --remove-unreferenced-resources=no", R"(Synonym for --remove-unreferenced-resources=no. Use that instead.
 )");
+}
+static void add_help_4(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--newline-before-endstream", "transformation", "force a newline before endstream", R"(For an extra newline before endstream. Using this option enables
 qpdf to preserve PDF/A when rewriting such files.
 )");
@@ -292,9 +329,6 @@ version. The version number format is
 to "major.minor" and the extension level, if specified, to
 "extension-level".
 )");
-}
-static void add_help_4(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--force-version", "transformation", "set output PDF version", R"(--force-version=version
 
 Force the output PDF file's PDF version header to be the specified
@@ -404,6 +438,9 @@ modified without updating its appearance. This option tells qpdf
 to generate new appearance streams. There are some limitations,
 which are discussed in the manual.
 )");
+}
+static void add_help_5(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--optimize-images", "modification", "use efficient compression for images", R"(Attempt to use DCT (JPEG) compression for images that fall
 within certain constraints as long as doing so decreases the
 size in bytes of the image. See also help for the following
@@ -427,9 +464,6 @@ Don't optimize images whose area in pixels is below the specified value.
 )");
 ap.addOptionHelp("--keep-inline-images", "modification", "exclude inline images from optimization", R"(Prevent inline images from being considered by --optimize-images.
 )");
-}
-static void add_help_5(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--remove-acroform", "modification", "remove the interactive form dictionary", R"(Exclude the interactive form dictionary from the output file. This
 option only removes the interactive form dictionary from the
 document catalog. It does not remove form field dictionaries or
@@ -603,6 +637,9 @@ ap.addOptionHelp("--extract", "encryption", "restrict text/graphic extraction",
 Enable/disable text/graphic extraction for purposes other than
 accessibility.
 )");
+}
+static void add_help_6(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--form", "encryption", "restrict form filling", R"(--form=[y|n]
 
 Enable/disable whether filling form fields is allowed even if
@@ -647,9 +684,6 @@ ap.addOptionHelp("--cleartext-metadata", "encryption", "don't encrypt metadata",
 encrypting the rest of the document. This option is not
 available with 40-bit encryption.
 )");
-}
-static void add_help_6(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--use-aes", "encryption", "use AES with 128-bit encryption", R"(--use-aes=[y|n]
 
 Enables/disables use of the more secure AES encryption with
@@ -805,6 +839,9 @@ Examples:
 - D:20210207161528-05'00'   February 7, 2021 at 4:15:28 p.m.
 - D:20210207211528Z         February 7, 2021 at 21:15:28 UTC
 )");
+}
+static void add_help_7(QPDFArgParser& ap)
+{
 ap.addHelpTopic("add-attachment", "attach (embed) files", R"(The options listed below appear between --add-attachment and its
 terminating "--".
 )");
@@ -833,9 +870,6 @@ Specify the attachment's modification date in PDF format;
 defaults to the current time. Run qpdf --help=pdf-dates for
 information about the date format.
 )");
-}
-static void add_help_7(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--mimetype", "add-attachment", "attachment mime type, e.g. application/pdf", R"(--mimetype=type/subtype
 
 Specify the mime type for the attachment, such as text/plain,
@@ -907,6 +941,9 @@ locations in the file) in a human-readable form. This is
 especially useful for files with cross-reference streams, which
 are stored in a binary format.
 )");
+}
+static void add_help_8(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--show-object", "inspection", "show contents of an object", R"(--show-object={trailer|obj[,gen]}
 
 Show the contents of the given object. This is especially useful
@@ -929,9 +966,6 @@ Useful for scripts.
 ap.addOptionHelp("--show-pages", "inspection", "display page dictionary information", R"(Show the object and generation number for each page dictionary
 object and for each content stream associated with the page.
 )");
-}
-static void add_help_8(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--with-images", "inspection", "include image details with --show-pages", R"(When used with --show-pages, also shows the object and
 generation numbers for the image objects on each page.
 )");
@@ -964,7 +998,10 @@ ap.addOptionHelp("--json-key", "json", "limit which keys are in JSON output", R"
 This option is repeatable. If given, only the specified
 top-level keys will be included in the JSON output. Otherwise,
 all keys will be included. With --json-output, when not given,
-only the "qpdf" key will appear in the output.
+only the "qpdf" key will appear in the output. The
+"streamdigests" key, which contains MD5 and SHA-256 digests of
+the raw and decoded data of each stream, is only included when
+given explicitly.
 )");
 ap.addOptionHelp("--json-object", "json", "limit which objects are in JSON", R"(--json-object={trailer|obj[,gen]}
 
@@ -1012,6 +1049,9 @@ option.
 ap.addHelpTopic("global", "options for changing the behaviour of qpdf", R"(The options below modify the overall behaviour of qpdf. This includes modifying
 implementation limits and changing modes of operation.
 )");
+}
+static void add_help_9(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--global", "global", "begin setting global options and limits", R"(--global [options] --
 
 Begin setting global options and limits.
@@ -1038,9 +1078,6 @@ parsing. The limit applies when the PDF document's xref table is undamaged
 and the object itself can be parsed without errors. The default limit
 is 4,294,967,295. See also --parser-max-container-size-damaged.
 )");
-}
-static void add_help_9(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--parser-max-container-size-damaged", "global", "set the maximum container size while parsing damaged files", R"(--parser-max-container-size-damaged=n
 
 Set the maximum number of top-level objects allowed in a container while
@@ -19,7 +19,7 @@ static char const* decode_level_choices[] = {"none", "generalized", "specialized
 static char const* object_streams_choices[] = {"disable", "preserve", "generate", 0};
 static char const* remove_unref_choices[] = {"auto", "yes", "no", 0};
 static char const* flatten_choices[] = {"all", "print", "screen", 0};
-static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", 0};
+static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", "streamdigests", 0};
 static char const* json_output_choices[] = {"2", "latest", 0};
 static char const* json_stream_data_choices[] = {"none", "inline", "file", 0};
 static char const* json_version_choices[] = {"1", "2", "latest", 0};
@@ -50,6 +50,8 @@ this->ap.addBare("check-linearization", [this](){c_main->checkLinearization();})
 this->ap.addBare("coalesce-contents", [this](){c_main->coalesceContents();});
 this->ap.addBare("copy-attachments-from", b(&ArgParser::argCopyAttachmentsFrom));
 this->ap.addBare("decrypt", [this](){c_main->decrypt();});
+this->ap.addBare("deduplicate-objects", [this](){c_main->deduplicateObjects();});
+this->ap.addBare("deduplicate-streams", [this](){c_main->deduplicateStreams();});
 this->ap.addBare("deterministic-id", [this](){c_main->deterministicId();});
 this->ap.addBare("empty", b(&ArgParser::argEmpty));
 this->ap.addBare("encrypt", b(&ArgParser::argEncrypt));
@@ -62,6 +64,7 @@ this->ap.addBare("ignore-xref-streams", [this](){c_main->ignoreXrefStreams();});
 this->ap.addBare("is-encrypted", [this](){c_main->isEncrypted();});
 this->ap.addBare("json-input", [this](){c_main->jsonInput();});
 this->ap.addBare("keep-inline-images", [this](){c_main->keepInlineImages();});
+this->ap.addBare("lazy-page-access", [this](){c_main->lazyPageAccess();});
 this->ap.addBare("linearize", [this](){c_main->linearize();});
 this->ap.addBare("list-attachments", [this](){c_main->listAttachments();});
 this->ap.addBare("newline-before-endstream", [this](){c_main->newlineBeforeEndstream();});
@@ -113,11 +116,13 @@ this->ap.addRequiredParameter("min-version", [this](std::string const& x){c_main
 this->ap.addRequiredParameter("oi-min-area", [this](std::string const& x){c_main->oiMinArea(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-height", [this](std::string const& x){c_main->oiMinHeight(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-width", [this](std::string const& x){c_main->oiMinWidth(x);}, "minimum");
+this->ap.addRequiredParameter("pages-tree-fanout", [this](std::string const& x){c_main->pagesTreeFanout(x);}, "count");
 this->ap.addRequiredParameter("password", [this](std::string const& x){c_main->password(x);}, "password");
 this->ap.addRequiredParameter("remove-attachment", [this](std::string const& x){c_main->removeAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("rotate", [this](std::string const& x){c_main->rotate(x);}, "[+|-]angle");
 this->ap.addRequiredParameter("show-attachment", [this](std::string const& x){c_main->showAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("show-object", [this](std::string const& x){c_main->showObject(x);}, "trailer");
+this->ap.addRequiredParameter("threads", [this](std::string const& x){c_main->threads(x);}, "count");
 this->ap.addRequiredParameter("copy-encryption", [this](std::string const& x){c_main->copyEncryption(x);}, "file");
 this->ap.addRequiredParameter("job-json-file", [this](std::string const& x){c_main->jobJsonFile(x);}, "file");
 this->ap.addRequiredParameter("linearize-pass1", [this](std::string const& x){c_main->linearizePass1(x);}, "filename");
@@ -12,7 +12,7 @@ static char const* decode_level_choices[] = {"none", "generalized", "specialized
 static char const* object_streams_choices[] = {"disable", "preserve", "generate", 0};
 static char const* remove_unref_choices[] = {"auto", "yes", "no", 0};
 static char const* flatten_choices[] = {"all", "print", "screen", 0};
-static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", 0};
+static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", "streamdigests", 0};
 static char const* json_output_choices[] = {"2", "latest", 0};
 static char const* json_stream_data_choices[] = {"none", "inline", "file", 0};
 static char const* json_version_choices[] = {"1", "2", "latest", 0};
@@ -47,6 +47,12 @@ popHandler(); // key: qdf
 pushKey("preserveUnreferenced");
 addBare([this]() { c_main->preserveUnreferenced(); });
 popHandler(); // key: preserveUnreferenced
+pushKey("deduplicateStreams");
+addBare([this]() { c_main->deduplicateStreams(); });
+popHandler(); // key: deduplicateStreams
+pushKey("deduplicateObjects");
+addBare([this]() { c_main->deduplicateObjects(); });
+popHandler(); // key: deduplicateObjects
 pushKey("newlineBeforeEndstream");
 addBare([this]() { c_main->newlineBeforeEndstream(); });
 popHandler(); // key: newlineBeforeEndstream
@@ -95,6 +101,9 @@ popHandler(); // key: linearizePass1
 pushKey("objectStreams");
 addChoices(object_streams_choices, true, [this](std::string const& p) { c_main->objectStreams(p); });
 popHandler(); // key: objectStreams
+pushKey("pagesTreeFanout");
+addParameter([this](std::string const& p) { c_main->pagesTreeFanout(p); });
+popHandler(); // key: pagesTreeFanout
 pushKey("minVersion");
 addParameter([this](std::string const& p) { c_main->minVersion(p); });
 popHandler(); // key: minVersion
@@ -305,6 +314,12 @@ popHandler(); // key: keepFilesOpen
 pushKey("keepFilesOpenThreshold");
 addParameter([this](std::string const& p) { c_main->keepFilesOpenThreshold(p); });
 popHandler(); // key: keepFilesOpenThreshold
+pushKey("lazyPageAccess");
+addBare([this]() { c_main->lazyPageAccess(); });
+popHandler(); // key: lazyPageAccess
+pushKey("threads");
+addParameter([this](std::string const& p) { c_main->threads(p); });
+popHandler(); // key: threads
 pushKey("noWarn");
 addBare([this]() { c_main->noWarn(); });
 popHandler(); // key: noWarn
@@ -8,6 +8,8 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "replaceInput": "overwrite input with output",
   "qdf": "enable viewing PDF code in a text editor",
   "preserveUnreferenced": "preserve unreferenced objects",
+  "deduplicateStreams": "write identical streams only once",
+  "deduplicateObjects": "write identical non-stream objects only once",
   "newlineBeforeEndstream": "force a newline before endstream",
   "normalizeContent": "fix newlines in content streams",
   "streamData": "control stream compression",
@@ -24,6 +26,7 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "linearize": "linearize (web-optimize) output",
   "linearizePass1": "save pass 1 of linearization",
   "objectStreams": "control use of object streams",
+  "pagesTreeFanout": "write a balanced pages tree",
   "minVersion": "set minimum PDF version",
   "forceVersion": "set output PDF version",
   "progress": "show progress when writing",
@@ -102,6 +105,8 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "allowWeakCrypto": "allow insecure cryptographic algorithms",
   "keepFilesOpen": "manage keeping multiple files open",
   "keepFilesOpenThreshold": "set threshold for keepFilesOpen",
+  "lazyPageAccess": "only read what is needed to copy selected pages",
+  "threads": "maximum number of threads for parallel work",
   "noWarn": "suppress printing of warning messages",
   "verbose": "print additional information",
   "testJsonSchema": "test generated json against schema",
@@ -1,8 +1,15 @@
 #include <qpdf/Buffer.hh>
 #include <qpdf/BufferInputSource.hh>
+#include <qpdf/ClosedFileInputSource.hh>
+#include <qpdf/FileInputSource.hh>
 #include <qpdf/QPDFTokenizer.hh>
+#include <qpdf/QUtil.hh>
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 static std::shared_ptr<Buffer>
 get_buffer()
@@ -50,6 +57,70 @@ check(char const* description, bool expected, bool actual)
     std::cout << description << ": " << ((actual == expected) ? "PASS" : "FAIL") << '\n';
 }
 
+static bool
+read_at_matches(InputSource& is, unsigned char const* data, size_t size)
+{
+    // Read the whole input in overlapping blocks and past the end.
+    char buf[100];
+    for (size_t offset = 0; offset < size + 50; offset += 37) {
+        auto expected = offset < size ? std::min(size - offset, sizeof(buf)) : 0;
+        if (is.readAt(static_cast<qpdf_offset_t>(offset), buf, sizeof(buf)) != expected ||
+            memcmp(buf, data + offset, expected) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+test_read_at()
+{
+    auto b = get_buffer();
+    auto data = b->getBuffer();
+    auto size = b->getSize();
+    char const* filename = "input_source.tmp";
+    FILE* f = QUtil::safe_fopen(filename, "wb");
+    fwrite(data, 1, size, f);
+    fclose(f);
+
+    BufferInputSource bis("buffer", b.get());
+    bis.seek(10, SEEK_SET);
+    check("buffer readAt", true, read_at_matches(bis, data, size));
+    check("buffer readAt keeps position", true, bis.tell() == 10);
+
+    FileInputSource fis(filename);
+    fis.seek(20, SEEK_SET);
+    char ch;
+    fis.read(&ch, 1);
+    check("file readAt", true, read_at_matches(fis, data, size));
+    check("file readAt keeps position", true, fis.tell() == 21);
+    fis.read(&ch, 1);
+    check("file read after readAt", true, ch == static_cast<char>(data[21]));
+
+    // Several threads reading from the same input at once
+    std::vector<std::thread> threads;
+    std::vector<char> results(8, 0);
+    for (auto& result: results) {
+        threads.emplace_back([&] {
+            bool ok = true;
+            for (int i = 0; i < 50; ++i) {
+                ok = ok && read_at_matches(fis, data, size);
+            }
+            result = ok ? 1 : 0;
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    check("concurrent file readAt", true, std::count(results.begin(), results.end(), 1) == 8);
+
+    // ClosedFileInputSource has no positional read of its own, so readAt seeks and reads.
+    ClosedFileInputSource cfis(filename);
+    check("closed file readAt", true, read_at_matches(cfis, data, size));
+
+    remove(filename);
+}
+
 int
 main()
 {
@@ -86,5 +157,6 @@ main()
     check("findLast found potato salad", true, is->findLast("potato", 0, 0, f1));
     check("findLast found first one", true, is->tell() == 2056);
 
+    test_read_at();
     return 0;
 }
@@ -1,12 +1,16 @@
 #include <qpdf/assert_test.h>
 
 #include <qpdf/JSON.hh>
+#include <qpdf/JSON_private.hh>
+#include <qpdf/InputSource_private.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/Pl_String.hh>
 #include <qpdf/QPDF.hh>
 #include <qpdf/QPDFObjectHandle.hh>
 
 #include <iostream>
+#include <map>
+#include <stdexcept>
 
 static void
 check(JSON const& j, std::string const& exp)
@@ -335,11 +339,92 @@ test_schema()
     check_schema(good, schema, JSON::f_optional, true, "pass");
 }
 
+namespace
+{
+    // Records the string values seen by dictionaryItem and skips the values of "skip" items.
+    class SkippingReactor: public qpdf::impl::JSONStreamingReactor
+    {
+      public:
+        ~SkippingReactor() override = default;
+        void
+        dictionaryStart() override
+        {
+        }
+        void
+        arrayStart() override
+        {
+        }
+        void
+        containerEnd(JSON const&) override
+        {
+        }
+        void
+        topLevelScalar() override
+        {
+        }
+        bool
+        dictionaryItem(std::string const& key, JSON const& value) override
+        {
+            std::string v;
+            if (value.getString(v)) {
+                items[key] = {v, value.getStart(), value.getEnd()};
+            }
+            return true;
+        }
+        bool
+        arrayItem(JSON const&) override
+        {
+            return true;
+        }
+        bool
+        skipStringValue(std::string const& key) override
+        {
+            return key == "skip";
+        }
+
+        struct Item
+        {
+            std::string value;
+            qpdf_offset_t start;
+            qpdf_offset_t end;
+        };
+        std::map<std::string, Item> items;
+    };
+} // namespace
+
+static void
+test_streaming_reactor()
+{
+    // Skipped strings are not accumulated even if they span many input buffers, but they are still
+    // validated and their offsets are reported.
+    std::string big(100'000, 'x');
+    std::string input = R"({"keep": "a\u0062c", "skip": ")" + big + R"(", "other": "d"})";
+    qpdf::is::OffsetBuffer is("streaming", input);
+    SkippingReactor r;
+    JSON::parse(is, &r);
+    assert(r.items.at("keep").value == "abc");
+    assert(r.items.at("other").value == "d");
+    auto const& skipped = r.items.at("skip");
+    assert(skipped.value.empty());
+    assert(input.substr(static_cast<size_t>(skipped.start), 2) == "\"x");
+    assert(skipped.end - skipped.start == static_cast<qpdf_offset_t>(big.size() + 2));
+
+    std::string bad = R"({"skip": ")" + big + R"(\x"})";
+    qpdf::is::OffsetBuffer bad_is("streaming", bad);
+    SkippingReactor r2;
+    try {
+        JSON::parse(bad_is, &r2);
+        assert(false);
+    } catch (std::runtime_error&) {
+    }
+}
+
 int
 main()
 {
     test_main();
     test_schema();
+    test_streaming_reactor();
     assert(QPDF::test_json_validators());
 
     std::cout << "end of json tests\n";
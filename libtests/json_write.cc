@@ -0,0 +1,174 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/JSON.hh>
+#include <qpdf/JSON_writer.hh>
+#include <qpdf/Pl_Discard.hh>
+#include <qpdf/Pl_String.hh>
+#include <qpdf/QUtil.hh>
+
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+
+// Straightforward reference implementation of JSON string encoding
+static std::string
+reference_encode(std::string const& str)
+{
+    std::string result;
+    for (auto c: str) {
+        auto ch = static_cast<unsigned char>(c);
+        switch (ch) {
+        case '\\':
+            result += "\\\\";
+            break;
+        case '"':
+            result += "\\\"";
+            break;
+        case '\b':
+            result += "\\b";
+            break;
+        case '\f':
+            result += "\\f";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (ch < 32) {
+                char buf[7];
+                snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                result += buf;
+            } else {
+                result += c;
+            }
+        }
+    }
+    return result;
+}
+
+static std::string
+written(std::string const& str)
+{
+    std::string out;
+    Pl_String p("string", nullptr, out);
+    JSON::Writer(&p, 0) << JSON::Writer::encoded(str);
+    return out;
+}
+
+static void
+check_string(std::string const& str)
+{
+    auto expected = reference_encode(str);
+    if (JSON::Writer::encode_string(str) != expected || written(str) != expected) {
+        std::cout << "encoding mismatch for string of length " << str.size() << '\n';
+    }
+}
+
+static void
+test_strings()
+{
+    // Place every byte value at every position of strings long enough to cover several eight-byte
+    // words, so that characters needing escapes are found in every lane of a word and in the
+    // trailing bytes.
+    for (size_t len = 0; len < 20; ++len) {
+        for (size_t pos = 0; pos < len; ++pos) {
+            for (int ch = 0; ch < 256; ++ch) {
+                std::string str(len, 'a');
+                str[pos] = static_cast<char>(ch);
+                check_string(str);
+            }
+        }
+    }
+    check_string("");
+    check_string("no escapes needed, including UTF-8: \xc3\xa9\xe2\x82\xac");
+    check_string("\"\\\"\\\"\\\x01\x1f\x7f\x80\xff");
+    std::string all;
+    for (int ch = 0; ch < 256; ++ch) {
+        all += static_cast<char>(ch);
+    }
+    check_string(all + all + all);
+}
+
+template <typename T>
+static void
+check_number(T val)
+{
+    std::string out;
+    Pl_String p("string", nullptr, out);
+    JSON::Writer(&p, 0) << val;
+    assert(out == std::to_string(val));
+    out.clear();
+    p << val;
+    assert(out == std::to_string(val));
+}
+
+static void
+test_numbers()
+{
+    for (int i: {0, 1, -1, 42, INT_MAX, INT_MIN}) {
+        check_number(i);
+    }
+    for (long long i: {0LL, -7LL, LLONG_MAX, LLONG_MIN}) {
+        check_number(i);
+    }
+    for (size_t i: {size_t(0), size_t(12345), std::numeric_limits<size_t>::max()}) {
+        check_number(i);
+    }
+    for (double d: {0.0, -0.0, 1.0, -1.5, 0.1, 3.14159265, 1e-7, 123456789.125, 1e20, -2.5e-3}) {
+        auto expected = QUtil::double_to_string(d, 6);
+        if (JSON::makeReal(d).unparse() != expected) {
+            std::cout << "real mismatch: " << JSON::makeReal(d).unparse() << " != " << expected
+                      << '\n';
+        }
+    }
+}
+
+static void
+benchmark(int iterations)
+{
+    // Typical JSON output consists mostly of short keys and values that need no escaping, with
+    // occasional longer strings and integers.
+    std::string plain = "/BaseFont /Helvetica-Bold and some more text of moderate length";
+    std::string escaped = "line one\nline \"two\"\tand a backslash \\ in the middle";
+    Pl_Discard discard;
+    JSON::Writer w(&discard, 0);
+
+    auto time = [iterations](char const* what, auto&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            fn(i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << what << ": " << elapsed.count() / iterations << " ns\n";
+    };
+    time("encode_string plain", [&](int) { (void)JSON::Writer::encode_string(plain); });
+    time("encode_string escaped", [&](int) { (void)JSON::Writer::encode_string(escaped); });
+    time("write encoded plain", [&](int) { w << JSON::Writer::encoded(plain); });
+    time("write encoded escaped", [&](int) { w << JSON::Writer::encoded(escaped); });
+    time("write integer", [&](int i) { w << static_cast<long long>(i) * 7919; });
+    time("make real", [&](int i) { (void)JSON::makeReal(i / 7.0); });
+}
+
+int
+main(int argc, char* argv[])
+{
+    // Run with --benchmark [iterations] to time JSON string and number writing.
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        benchmark(argc > 2 ? QUtil::string_to_int(argv[2]) : 1'000'000);
+        return 0;
+    }
+    test_strings();
+    test_numbers();
+    std::cout << "json write tests done\n";
+    return 0;
+}
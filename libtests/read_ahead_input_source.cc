@@ -0,0 +1,250 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/Buffer.hh>
+#include <qpdf/BufferInputSource.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QPDFWriter.hh>
+#include <qpdf/ReadAheadInputSource.hh>
+
+#include <cstring>
+#include <iostream>
+
+// An input source that counts the reads done on another input source.
+class CountingInputSource: public InputSource
+{
+  public:
+    CountingInputSource(std::shared_ptr<InputSource> is) :
+        is(is)
+    {
+    }
+    ~CountingInputSource() override = default;
+    qpdf_offset_t
+    findAndSkipNextEOL() override
+    {
+        return is->findAndSkipNextEOL();
+    }
+    std::string const&
+    getName() const override
+    {
+        return is->getName();
+    }
+    qpdf_offset_t
+    tell() override
+    {
+        return is->tell();
+    }
+    void
+    seek(qpdf_offset_t offset, int whence) override
+    {
+        is->seek(offset, whence);
+    }
+    void
+    rewind() override
+    {
+        is->rewind();
+    }
+    size_t
+    read(char* buffer, size_t length) override
+    {
+        ++reads;
+        auto result = is->read(buffer, length);
+        last_offset = is->getLastOffset();
+        return result;
+    }
+    void
+    unreadCh(char ch) override
+    {
+        is->unreadCh(ch);
+    }
+
+    size_t reads{0};
+
+  private:
+    std::shared_ptr<InputSource> is;
+};
+
+// Accept every match and skip past its first character, as the finders used by QPDF skip past the
+// tokens they check.
+class SkipFinder: public InputSource::Finder
+{
+  public:
+    SkipFinder(InputSource& is) :
+        is(is)
+    {
+    }
+    ~SkipFinder() override = default;
+    bool
+    check() override
+    {
+        char ch;
+        is.read(&ch, 1);
+        return true;
+    }
+
+  private:
+    InputSource& is;
+};
+
+static std::string
+make_data()
+{
+    std::string data;
+    for (int i = 0; i < 500; ++i) {
+        data += "line " + std::to_string(i) + (i % 3 ? "\n" : i % 5 ? "\r\n" : "\r\r\n\n");
+    }
+    return data;
+}
+
+static void
+compare(InputSource& a, InputSource& b, size_t length)
+{
+    std::string buf_a(length, '\0');
+    std::string buf_b(length, '\0');
+    auto len_a = a.read(buf_a.data(), length);
+    auto len_b = b.read(buf_b.data(), length);
+    assert(len_a == len_b);
+    assert(buf_a.compare(0, len_a, buf_b, 0, len_b) == 0);
+    assert(a.tell() == b.tell());
+    assert(a.getLastOffset() == b.getLastOffset());
+}
+
+static void
+test_equivalence(size_t block_size, size_t max_blocks)
+{
+    auto data = make_data();
+    Buffer buffer(data);
+    auto plain = std::make_shared<BufferInputSource>("data", &buffer);
+    auto under = std::make_shared<BufferInputSource>("data", &buffer);
+    ReadAheadInputSource ra(under, block_size, max_blocks);
+    InputSource& p = *plain;
+
+    assert(ra.getName() == "data");
+    // Forward reads of various sizes, including reads that span blocks and reach the end
+    for (size_t length: {1U, 7U, 100U, 3U, 2000U, 17U}) {
+        compare(p, ra, length);
+    }
+    while (p.tell() < static_cast<qpdf_offset_t>(data.size())) {
+        compare(p, ra, 13);
+    }
+    compare(p, ra, 10);
+    // Backward reads
+    for (qpdf_offset_t offset = static_cast<qpdf_offset_t>(data.size()) - 5; offset >= 0;
+         offset -= 11) {
+        p.seek(offset, SEEK_SET);
+        ra.seek(offset, SEEK_SET);
+        compare(p, ra, 5);
+    }
+    // Relative seeks, unreading, and reading lines
+    p.seek(-100, SEEK_END);
+    ra.seek(-100, SEEK_END);
+    assert(p.tell() == ra.tell());
+    p.seek(-50, SEEK_CUR);
+    ra.seek(-50, SEEK_CUR);
+    compare(p, ra, 1);
+    p.unreadCh('x');
+    ra.unreadCh('x');
+    compare(p, ra, 4);
+    p.rewind();
+    ra.rewind();
+    while (p.tell() < static_cast<qpdf_offset_t>(data.size())) {
+        assert(p.readLine(30) == ra.readLine(30));
+        assert(p.findAndSkipNextEOL() == ra.findAndSkipNextEOL());
+        assert(p.tell() == ra.tell());
+    }
+    try {
+        ra.seek(-1, SEEK_SET);
+        assert(false);
+    } catch (std::runtime_error& e) {
+        assert(std::string(e.what()) == "data: seek before beginning of file");
+    }
+    // Searching backwards
+    SkipFinder p_finder(p);
+    SkipFinder ra_finder(ra);
+    assert(p.findLast("line 4", 0, 0, p_finder) == ra.findLast("line 4", 0, 0, ra_finder));
+    assert(p.tell() == ra.tell());
+    assert(p.findFirst("line 4", 0, 0, p_finder) == ra.findFirst("line 4", 0, 0, ra_finder));
+    assert(p.tell() == ra.tell());
+    // Positional reads
+    char a[50];
+    char b[50];
+    for (qpdf_offset_t offset = 0; offset < static_cast<qpdf_offset_t>(data.size()) + 50;
+         offset += 23) {
+        auto len = p.readAt(offset, a, sizeof(a));
+        assert(ra.readAt(offset, b, sizeof(b)) == len);
+        assert(memcmp(a, b, len) == 0);
+    }
+}
+
+static void
+test_reads_saved()
+{
+    auto data = make_data();
+    Buffer buffer(data);
+    auto direct = std::make_shared<CountingInputSource>(
+        std::make_shared<BufferInputSource>("data", &buffer));
+    auto counted = std::make_shared<CountingInputSource>(
+        std::make_shared<BufferInputSource>("data", &buffer));
+    ReadAheadInputSource ra(counted, 4096, 2);
+    SkipFinder direct_finder(*direct);
+    SkipFinder ra_finder(ra);
+    direct->findLast("line 1", 0, 0, direct_finder);
+    ra.findLast("line 1", 0, 0, ra_finder);
+    assert(direct->tell() == ra.tell());
+    assert(ra.getUnderlyingReads() <= counted->reads);
+    assert(ra.getUnderlyingBytes() >= data.size());
+    assert(counted->reads * 10 < direct->reads);
+}
+
+static void
+test_damaged_pdf()
+{
+    // Write a file with a few pages and break its xref table so that it has to be reconstructed.
+    QPDF pdf;
+    pdf.emptyPDF();
+    for (int i = 0; i < 20; ++i) {
+        auto page = pdf.makeIndirectObject(
+            QPDFObjectHandle::parse("<< /Type /Page /MediaBox [0 0 612 792] >>"));
+        pdf.addPage(page, false);
+    }
+    QPDFWriter w(pdf);
+    w.setOutputMemory();
+    w.setObjectStreamMode(qpdf_o_disable);
+    w.write();
+    auto written = w.getBufferSharedPointer();
+    std::string data(reinterpret_cast<char*>(written->getBuffer()), written->getSize());
+    auto xref = data.rfind("startxref");
+    assert(xref != std::string::npos);
+    data.replace(xref + 10, 1, "9");
+    Buffer buffer(data);
+
+    auto direct = std::make_shared<CountingInputSource>(
+        std::make_shared<BufferInputSource>("damaged.pdf", &buffer));
+    QPDF q1;
+    q1.setSuppressWarnings(true);
+    q1.processInputSource(direct);
+    assert(q1.getAllPages().size() == 20);
+    assert(q1.anyWarnings());
+
+    auto counted = std::make_shared<CountingInputSource>(
+        std::make_shared<BufferInputSource>("damaged.pdf", &buffer));
+    auto ra = std::make_shared<ReadAheadInputSource>(counted, 4096);
+    QPDF q2;
+    q2.setSuppressWarnings(true);
+    q2.processInputSource(ra);
+    assert(q2.getAllPages().size() == 20);
+    assert(q1.getWarnings().size() == q2.getWarnings().size());
+    assert(counted->reads < direct->reads);
+}
+
+int
+main()
+{
+    test_equivalence(65536, 4);
+    test_equivalence(16, 3);
+    test_equivalence(1, 1);
+    test_equivalence(100, 1);
+    test_reads_saved();
+    test_damaged_pdf();
+    std::cout << "read-ahead input source tests done\n";
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/WorkerPool.hh>
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace qpdf;
+
+static void
+test_runs(size_t size)
+{
+    WorkerPool pool(size);
+    assert(pool.size() == size);
+    // Reuse the pool for several runs of different sizes, including runs with fewer tasks than
+    // threads and runs with no tasks.
+    for (size_t count: {0U, 1U, 3U, 100U, 2U, 1000U}) {
+        std::vector<int> calls(count, 0);
+        std::atomic<size_t> total{0};
+        pool.run(count, [&](size_t i) {
+            ++calls[i];
+            total += i;
+        });
+        for (auto c: calls) {
+            assert(c == 1);
+        }
+        assert(total == count * (count ? count - 1 : 0) / 2);
+    }
+}
+
+static void
+test_exceptions()
+{
+    WorkerPool pool(4);
+    std::atomic<size_t> calls{0};
+    try {
+        pool.run(50, [&](size_t i) {
+            ++calls;
+            if (i % 7 == 3) {
+                throw std::runtime_error("task failed");
+            }
+        });
+        assert(false);
+    } catch (std::runtime_error& e) {
+        assert(std::string(e.what()) == "task failed");
+    }
+    // All tasks ran despite the failures, and the pool is still usable.
+    assert(calls == 50);
+    calls = 0;
+    pool.run(10, [&](size_t) { ++calls; });
+    assert(calls == 10);
+}
+
+int
+main()
+{
+    test_runs(1);
+    test_runs(2);
+    test_runs(8);
+    assert(WorkerPool(0).size() >= 1);
+    test_exceptions();
+    std::cout << "worker pool tests done\n";
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include <qpdf/Pl_Buffer.hh>
 #include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_Flate.hh>
+#include <qpdf/Pl_QPDFTokenizer.hh>
 #include <qpdf/Pl_StdioFile.hh>
 #include <qpdf/Pl_String.hh>
 #include <qpdf/QIntC.hh>
@@ -31,9 +32,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <thread>
 
 static char const* whoami = nullptr;
 
@@ -3598,6 +3601,334 @@ test_102(QPDF& pdf, char const* arg2)
     j2.writeQPDF(*q);
 }
 
+static void
+check_balanced_pages_tree(QPDF& pdf, std::vector<QPDFObjectHandle> const& expected, size_t fanout)
+{
+    auto const& pages = pdf.getAllPages();
+    assert(pages.size() == expected.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        assert(pages.at(i).isSameObjectAs(expected.at(i)));
+        assert(pdf.findPage(pages.at(i).getObjGen()) == QIntC::to_int(i));
+    }
+    // Check /Count, /Parent, node sizes, and that all pages are at the same depth.
+    int page_depth = -1;
+    std::function<size_t(QPDFObjectHandle, QPDFObjectHandle, int)> check =
+        [&](QPDFObjectHandle node, QPDFObjectHandle parent, int depth) -> size_t {
+        if (!node.hasKey("/Kids")) {
+            assert(node.getKey("/Parent").isSameObjectAs(parent));
+            assert(page_depth == -1 || page_depth == depth);
+            page_depth = depth;
+            return 1;
+        }
+        auto kids = node.getKey("/Kids").getArrayAsVector();
+        assert(kids.size() <= fanout);
+        if (depth > 0) {
+            assert(node.getKey("/Parent").isSameObjectAs(parent));
+            assert(kids.size() >= (fanout + 1) / 2);
+        }
+        size_t count = 0;
+        for (auto& kid: kids) {
+            count += check(kid, node, depth + 1);
+        }
+        assert(node.getKey("/Count").getUIntValue() == count);
+        return count;
+    };
+    assert(check(pdf.getRoot().getKey("/Pages"), {}, 0) == expected.size());
+}
+
+static void
+test_103(QPDF& pdf, char const* arg2)
+{
+    // Balanced pages tree: interleave insertions and removals
+    size_t const fanout = 3;
+    pdf.setPagesTreeFanout(fanout);
+    std::vector<QPDFObjectHandle> expected = pdf.getAllPages();
+    auto originals = expected;
+    unsigned int seed = 17;
+    auto next = [&seed](size_t n) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<size_t>((seed >> 16) % n);
+    };
+    for (int i = 0; i < 400; ++i) {
+        if (expected.empty() || next(3) > 0) {
+            auto page = pdf.makeIndirectObject(originals.at(next(originals.size())).shallowCopy());
+            auto pos = next(expected.size() + 1);
+            if (pos == expected.size()) {
+                pdf.addPage(page, false);
+            } else {
+                pdf.addPageAt(page, true, expected.at(pos));
+            }
+            expected.insert(expected.begin() + QIntC::to_int(pos), page);
+        } else {
+            auto pos = next(expected.size());
+            pdf.removePage(expected.at(pos));
+            expected.erase(expected.begin() + QIntC::to_int(pos));
+        }
+        check_balanced_pages_tree(pdf, expected, fanout);
+    }
+    while (expected.size() > 2) {
+        auto pos = next(expected.size());
+        pdf.removePage(expected.at(pos));
+        expected.erase(expected.begin() + QIntC::to_int(pos));
+        check_balanced_pages_tree(pdf, expected, fanout);
+    }
+    // Rereading the pages tree must produce the same pages.
+    pdf.updateAllPagesCache();
+    check_balanced_pages_tree(pdf, expected, fanout);
+    std::cout << "pages: " << pdf.getAllPages().size() << '\n';
+
+    for (size_t bad: {1U, 2U}) {
+        try {
+            pdf.setPagesTreeFanout(bad);
+            assert(false);
+        } catch (std::invalid_argument& e) {
+            std::cout << e.what() << '\n';
+        }
+    }
+}
+
+static void
+test_104(QPDF& pdf, char const* arg2)
+{
+    // Cross-reference index files
+    char const* index = "auto-xref-index";
+    auto written = [](QPDF& q) {
+        QPDFWriter w(q);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.write();
+        auto b = w.getBufferSharedPointer();
+        return std::string(reinterpret_cast<char*>(b->getBuffer()), b->getSize());
+    };
+
+    assert(!pdf.usedXRefIndexFile());
+    pdf.writeXRefIndexFile(index);
+    std::cout << "reading with index\n";
+    QPDF indexed;
+    indexed.setXRefIndexFile(index);
+    indexed.processFile(pdf.getFilename().c_str());
+    assert(indexed.usedXRefIndexFile());
+    // Loading an index for a reconstructed xref table warns that the file is damaged.
+    assert(indexed.anyWarnings() == pdf.anyWarnings());
+    auto xref = pdf.getXRefTable();
+    auto indexed_xref = indexed.getXRefTable();
+    assert(xref.size() == indexed_xref.size());
+    for (auto const& [og, entry]: xref) {
+        auto const& other = indexed_xref.at(og);
+        assert(entry.getType() == other.getType());
+        if (entry.getType() == 1) {
+            assert(entry.getOffset() == other.getOffset());
+        } else {
+            assert(entry.getObjStreamNumber() == other.getObjStreamNumber());
+            assert(entry.getObjStreamIndex() == other.getObjStreamIndex());
+        }
+    }
+    assert(pdf.getTrailer().unparse() == indexed.getTrailer().unparse());
+    assert(written(pdf) == written(indexed));
+
+    // The index doesn't match other files and is ignored if missing.
+    QPDF other;
+    other.setXRefIndexFile(index);
+    other.processFile("minimal.pdf");
+    assert(!other.usedXRefIndexFile());
+    QPDF missing;
+    missing.setXRefIndexFile("auto-missing-xref-index");
+    missing.processFile("minimal.pdf");
+    assert(!missing.usedXRefIndexFile());
+
+    // An index for a reconstructed xref table is not used when recovery is suppressed.
+    QPDF no_recovery;
+    no_recovery.setAttemptRecovery(false);
+    no_recovery.setXRefIndexFile(index);
+    try {
+        no_recovery.processFile(pdf.getFilename().c_str());
+        assert(!pdf.anyWarnings());
+        assert(no_recovery.usedXRefIndexFile());
+    } catch (QPDFExc& e) {
+        assert(pdf.anyWarnings());
+        assert(!no_recovery.usedXRefIndexFile());
+        std::cout << "without recovery: " << e.what() << '\n';
+    }
+
+    // Truncated indexes are ignored, including when truncated at a line boundary or when an entry
+    // is missing.
+    auto contents = QUtil::read_file_into_string(index);
+    auto end_marker = contents.rfind('\n', contents.size() - 2) + 1;
+    auto last_entry = contents.rfind('\n', end_marker - 2) + 1;
+    for (auto const& damaged:
+         {contents.substr(0, contents.size() / 2),
+          contents.substr(0, end_marker),
+          contents.substr(0, last_entry) + contents.substr(end_marker)}) {
+        {
+            QUtil::FileCloser fc(QUtil::safe_fopen(index, "wb"));
+            fwrite(damaged.data(), 1, damaged.size(), fc.f);
+        }
+        QPDF truncated;
+        truncated.setXRefIndexFile(index);
+        truncated.processFile(pdf.getFilename().c_str());
+        assert(!truncated.usedXRefIndexFile());
+    }
+    QUtil::remove_file(index);
+}
+
+static void
+test_105(QPDF& pdf, char const* arg2)
+{
+    // Parallel xref reconstruction gives the same results as a serial scan, including when the file
+    // is split into chunks that are much smaller than its lines.
+    auto recover = [arg2](size_t threads) {
+        std::string result;
+        QPDF q;
+        q.setSuppressWarnings(true);
+        q.setXRefReconstructionThreads(threads);
+        try {
+            q.processFile(arg2);
+            (void)q.getAllObjects();
+            for (auto const& [og, entry]: q.getXRefTable()) {
+                result += og.unparse(' ') + " " + std::to_string(entry.getType()) + " " +
+                    std::to_string(
+                              entry.getType() == 1 ? entry.getOffset()
+                                                   : entry.getObjStreamNumber()) +
+                    "\n";
+            }
+            result += q.getTrailer().unparse() + "\n";
+        } catch (std::exception& e) {
+            result += std::string("exception: ") + e.what() + "\n";
+        }
+        for (auto const& w: q.getWarnings()) {
+            result += std::string(w.what()) + "\n";
+        }
+        return result;
+    };
+    auto serial = recover(1);
+    assert(serial.find("Attempting to reconstruct cross-reference table") != std::string::npos);
+    for (size_t threads: {2U, 3U, 7U, 100U}) {
+        assert(recover(threads) == serial);
+    }
+    std::cout << arg2 << ": parallel reconstruction matches" << '\n';
+}
+
+static void
+test_106(QPDF& pdf, char const* arg2)
+{
+    // Writing selected objects as JSON reads only the selected objects. Nonexistent objects are
+    // ignored.
+    std::string out;
+    Pl_String pl("json", nullptr, out);
+    std::set<std::string> wanted{"obj:3 0 R", "obj:10 0 R", "obj:1000 0 R", "trailer"};
+    pdf.writeJSON(2, &pl, qpdf_dl_none, qpdf_sj_none, "", wanted);
+    std::cout << out << '\n';
+    std::cout << "resolved: " << pdf.getResolvedObjectCount() << '\n';
+    std::cout << "objects: " << pdf.getObjectCount() << '\n';
+}
+
+static void
+test_107(QPDF& pdf, char const* arg2)
+{
+    // After makeReadOnlySnapshot, several threads can read the same document at once. Each thread
+    // summarizes every page's content streams and image data, which must match the summary
+    // computed before any threads were started.
+    pdf.makeReadOnlySnapshot();
+    auto resolved = pdf.getResolvedObjectCount();
+    auto summarize = [&pdf]() {
+        std::string result;
+        auto add_stream = [&result](QPDFObjectHandle stream) {
+            std::string data;
+            Pl_String pl("data", nullptr, data);
+            bool ok = stream.pipeStreamData(&pl, 0, qpdf_dl_generalized);
+            result += stream.getObjGen().unparse(' ') + (ok ? " " : " (raw) ") +
+                std::to_string(data.size()) + " " +
+                std::to_string(std::hash<std::string>{}(data)) + "\n";
+        };
+        for (auto& page: pdf.getAllPages()) {
+            result += page.getKey("/MediaBox").unparse() + "\n";
+            auto contents = page.getKey("/Contents");
+            if (contents.isStream()) {
+                add_stream(contents);
+            } else {
+                for (auto& item: contents.aitems()) {
+                    add_stream(item);
+                }
+            }
+            auto resources = page.getKey("/Resources");
+            if (resources.isDictionary() && resources.getKey("/XObject").isDictionary()) {
+                for (auto& [key, xobject]: resources.getKey("/XObject").ditems()) {
+                    if (xobject.isStream()) {
+                        add_stream(xobject);
+                    }
+                }
+            }
+        }
+        return result;
+    };
+    auto expected = summarize();
+    std::vector<std::string> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result: results) {
+        threads.emplace_back([&result, &summarize] {
+            for (int i = 0; i < 4; ++i) {
+                result = summarize();
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    for (auto const& result: results) {
+        assert(result == expected);
+    }
+    std::cout << "objects resolved while reading: " << (pdf.getResolvedObjectCount() - resolved)
+              << '\n';
+    std::cout << "pages: " << pdf.getAllPages().size() << '\n';
+    std::cout << "threads match" << '\n';
+}
+
+static void
+test_108(QPDF& pdf, char const* arg2)
+{
+    // Pl_QPDFTokenizer passes on tokens as data is written. Writing each page's content in pieces
+    // of any size, including pieces that split tokens and inline images, must give the same tokens
+    // as writing it all at once.
+    class Recorder: public QPDFObjectHandle::TokenFilter
+    {
+      public:
+        ~Recorder() override = default;
+        void
+        handleToken(QPDFTokenizer::Token const& t) override
+        {
+            tokens.emplace_back(std::to_string(t.getType()) + ":" + t.getRawValue());
+        }
+        std::vector<std::string> tokens;
+    };
+    auto tokenize = [](std::string const& content, size_t piece) {
+        Recorder recorder;
+        Pl_QPDFTokenizer tokenizer("tokenizer", &recorder);
+        auto data = reinterpret_cast<unsigned char const*>(content.data());
+        for (size_t offset = 0; offset < content.size(); offset += piece) {
+            tokenizer.write(data + offset, std::min(piece, content.size() - offset));
+        }
+        tokenizer.finish();
+        return recorder.tokens;
+    };
+    size_t inline_images = 0;
+    for (auto& page: QPDFPageDocumentHelper(pdf).getAllPages()) {
+        std::string content;
+        Pl_String pl("content", nullptr, content);
+        page.pipeContents(&pl);
+        auto expected = tokenize(content, content.size() + 1);
+        for (auto const& t: expected) {
+            if (t.starts_with(std::to_string(QPDFTokenizer::tt_inline_image) + ":")) {
+                ++inline_images;
+            }
+        }
+        for (size_t piece: {1U, 3U, 64U, 1000U}) {
+            assert(tokenize(content, piece) == expected);
+        }
+    }
+    std::cout << "inline images: " << inline_images << '\n';
+    std::cout << "pieces match" << '\n';
+}
+
 void
 runtest(int n, char const* filename1, char const* arg2)
 {
@@ -3605,7 +3936,7 @@ runtest(int n, char const* filename1, char const* arg2)
     // the test suite to see how the test is invoked to find the file
     // that the test is supposed to operate on.
 
-    std::set<int> ignore_filename = {61, 62, 81, 83, 84, 85, 86, 87, 92, 95, 96, 101, 102};
+    std::set<int> ignore_filename = {61, 62, 81, 83, 84, 85, 86, 87, 92, 95, 96, 101, 102, 105};
 
     if (n == 0) {
         // Throw in some random test cases that don't fit anywhere
@@ -3699,7 +4030,8 @@ runtest(int n, char const* filename1, char const* arg2)
         {85, test_85},   {86, test_86},   {87, test_87},  {88, test_88}, {89, test_89},
         {90, test_90},   {91, test_91},   {92, test_92},  {93, test_93}, {94, test_94},
         {95, test_95},   {96, test_96},   {97, test_97},  {98, test_98}, {99, test_99},
-        {100, test_100}, {101, test_101}, {102, test_102}};
+        {100, test_100}, {101, test_101}, {102, test_102}, {103, test_103}, {104, test_104},
+        {105, test_105}, {106, test_106}, {107, test_107}, {108, test_108}};
 
     auto fn = test_functions.find(n);
     if (fn == test_functions.end()) {